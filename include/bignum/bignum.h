@@ -14,7 +14,10 @@
 #include "bignum/bn_limits.h"
 #include "bignum/bn_except.h"
 #include "bignum/bn_int_type.h"
+#include "bignum/bn_thresholds.h"
 #include "bignum/bn_type.h"
+#include "bignum/bn_multiplier.h"
+#include "bignum/bn_divisor.h"
 
 
 
@@ -43,6 +46,34 @@ BN_DECLARE_CLASS(Bignum, bignum_base16, bn_limits_base16, bn_default_container_t
  */
 typedef bignum_highp bignum;
 
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_lowp, bn_limits_lowp, bn_default_container_t<bn_limits_lowp::base_single>);
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_medp, bn_limits_medp, bn_default_container_t<bn_limits_medp::base_single>);
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_highp, bn_limits_highp, bn_default_container_t<bn_limits_highp::base_single>);
+
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_base2, bn_limits_base2, bn_default_container_t<bn_limits_base2::base_single>);
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_base8, bn_limits_base8, bn_default_container_t<bn_limits_base8::base_single>);
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_base10, bn_limits_base10, bn_default_container_t<bn_limits_base10::base_single>);
+BN_DECLARE_CLASS(BignumMultiplier, bignum_multiplier_base16, bn_limits_base16, bn_default_container_t<bn_limits_base16::base_single>);
+
+/**
+ * Default-precision constant factor
+ */
+typedef bignum_multiplier_highp bignum_multiplier;
+
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_lowp, bn_limits_lowp, bn_default_container_t<bn_limits_lowp::base_single>);
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_medp, bn_limits_medp, bn_default_container_t<bn_limits_medp::base_single>);
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_highp, bn_limits_highp, bn_default_container_t<bn_limits_highp::base_single>);
+
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_base2, bn_limits_base2, bn_default_container_t<bn_limits_base2::base_single>);
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_base8, bn_limits_base8, bn_default_container_t<bn_limits_base8::base_single>);
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_base10, bn_limits_base10, bn_default_container_t<bn_limits_base10::base_single>);
+BN_DECLARE_CLASS(BignumDivisor, bignum_divisor_base16, bn_limits_base16, bn_default_container_t<bn_limits_base16::base_single>);
+
+/**
+ * Default-precision constant divisor
+ */
+typedef bignum_divisor_highp bignum_divisor;
+
 
 
 #endif	/* __BIGNUM_H__ */
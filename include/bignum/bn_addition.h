@@ -24,6 +24,22 @@ template <typename limits_t, typename container_t>
 void abs_val_add(container_t& outNum, const container_t& inNum);
 
 
+/**
+ * Add a number, shifted up by a number of digits, into the first parameter.
+ * This function is not designed to compare a bignum's descriptors.
+ * 
+ * @param The bignum_type where all numerical values will be
+ * accumulated.
+ * 
+ * @param A number to add into the first.
+ * 
+ * @param The number of digits to shift the second parameter by before adding
+ * it (i.e. the second parameter is multiplied by base^shift).
+ */
+template <typename limits_t, typename container_t>
+void abs_val_add_shifted(container_t& outNum, const container_t& inNum, typename container_t::size_type shift);
+
+
 
 #include "bignum/impl/bn_addition_impl.h"
 
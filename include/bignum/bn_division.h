@@ -12,19 +12,337 @@
 
         
 /**
- * Divide one number by the second parameter.
+ * Long division by Knuth's Algorithm D, producing one quotient digit per
+ * step from an estimate made with the top digits of the remainder.
+ * 
+ * The divisor must have at least 2 digits and be normalized, with its top
+ * digit no less than half of the numerical base. The dividend must have
+ * more digits than the divisor, and its top digit must make it less than
+ * the divisor shifted up by (uLen-vLen) digits.
+ * 
+ * Writes (uLen-vLen) quotient digits to q, and leaves the remainder in the
+ * lowest vLen digits of u.
+ */
+template <typename limits_t, typename container_t>
+void div_knuth_kernel(
+    bn_iter_t<container_t> u, bn_size_t<container_t> uLen,
+    bn_citer_t<container_t> v, bn_size_t<container_t> vLen,
+    bn_iter_t<container_t> q
+);
+
+
+
+/**
+ * Long division of a number by a normalized divisor, using
+ * div_knuth_kernel().
+ * 
+ * @param The dividend, which receives the remainder with no leading zeroes.
+ * 
+ * @param A divisor of at least 2 digits, with its top digit no less than
+ * half of the numerical base.
+ * 
+ * @return The quotient, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t div_knuth(container_t& u, const container_t& v);
+
+
+
+/**
+ * Shortest divisor and quotient for which division uses Newton's method.
+ * Reciprocals of fewer digits are computed with div_knuth_kernel(), which
+ * also keeps the final corrections of each Newton step from recursing.
+ */
+constexpr std::size_t BN_NEWTON_MIN_LEN = 16;
+
+
+
+/**
+ * Compute the reciprocal of a divisor with Newton's iteration, doubling the
+ * precision at each step from a reciprocal of the divisor's top half.
+ * 
+ * The divisor must be normalized, with its top digit no less than half of
+ * the numerical base.
+ * 
+ * @return floor(base^(2*vLen) / v), with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t div_newton_reciprocal(bn_citer_t<container_t> v, bn_size_t<container_t> vLen);
+
+
+
+/**
+ * Divide a number by a normalized divisor using a reciprocal from
+ * div_newton_reciprocal(), in the manner of Barrett's reduction. The
+ * dividend is consumed in blocks of the divisor's length, each of which
+ * costs two multiplications.
+ * 
+ * @param The dividend, which receives the remainder with no leading zeroes.
+ * 
+ * @param A divisor of at least 2 digits, with its top digit no less than
+ * half of the numerical base.
+ * 
+ * @param The reciprocal of the divisor.
+ * 
+ * @return The quotient, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t div_reciprocal(container_t& u, const container_t& v, const container_t& recip);
+
+
+
+/**
+ * Divide a number by a normalized divisor, computing its reciprocal with
+ * div_newton_reciprocal() and dividing with div_reciprocal().
+ * 
+ * @param The dividend, which receives the remainder with no leading zeroes.
+ * 
+ * @param A divisor of at least 2 digits, with its top digit no less than
+ * half of the numerical base.
+ * 
+ * @return The quotient, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t div_newton(container_t& u, const container_t& v);
+
+
+
+/**
+ * Shortest divisor for which division recurses with the Burnikel-Ziegler
+ * method. Shorter halves are divided by div_knuth().
+ */
+constexpr std::size_t BN_BURNIKEL_MIN_LEN = 8;
+
+
+
+/**
+ * Recursive division of a 2n-digit number by an n-digit one, from
+ * Burnikel and Ziegler's "Fast Recursive Division". The division is split
+ * into two divisions of 3 halves by 2 halves, each of which recurses on
+ * the top halves and corrects the result with one multiplication.
+ * 
+ * @param The dividend, which must be less than the divisor times base^n.
+ * It receives the remainder, with no leading zeroes.
+ * 
+ * @param A divisor of exactly n digits, with its top digit no less than
+ * half of the numerical base.
+ * 
+ * @param The length of the divisor.
+ * 
+ * @return The quotient, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t div_burnikel_2n1n(container_t& a, const container_t& b, bn_size_t<container_t> n);
+
+
+
+/**
+ * Divide the 3 halves [a1 a2 a3] by the 2 halves [b1 b2] of a divisor, as
+ * one step of div_burnikel_2n1n().
+ * 
+ * @param The top two halves of the dividend, which must be less than the
+ * divisor times base^n. It receives the remainder, with no leading zeroes.
+ * 
+ * @param The lowest half of the dividend.
+ * 
+ * @param The normalized divisor, of 2n digits.
+ * 
+ * @param The top half of the divisor.
+ * 
+ * @param The lowest half of the divisor, with no leading zeroes.
+ * 
+ * @param The length of each half.
+ * 
+ * @return The quotient, of no more than n digits.
+ */
+template <typename limits_t, typename container_t>
+container_t div_burnikel_3n2n(
+    container_t& a12,
+    const container_t& a3,
+    const container_t& b,
+    const container_t& b1,
+    const container_t& b2,
+    bn_size_t<container_t> n
+);
+
+
+
+/**
+ * Divide a number by a normalized divisor with div_burnikel_2n1n(),
+ * consuming the dividend in blocks of the divisor's length.
+ * 
+ * @param The dividend, which receives the remainder with no leading zeroes.
+ * It must be at least as long as the divisor.
+ * 
+ * @param A divisor of at least 2 digits, with its top digit no less than
+ * half of the numerical base.
+ * 
+ * @return The quotient, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t div_burnikel(container_t& u, const container_t& v);
+
+
+
+/**
+ * Divide one number by the second parameter, keeping the remainder. Uses
+ * abs_val_div_small() for single-digit divisors. Longer divisors use
+ * div_newton() once both the divisor and quotient reach
+ * BNThresholds<limits_t>::divNewton digits, div_burnikel() once they reach
+ * BNThresholds<limits_t>::divBurnikel, and div_knuth() otherwise.
  * This function is not designed to compare a bignum's descriptors.
  * 
  * @param The bignum_type where all numerical values will be
- * divided.
+ * divided. It receives the quotient, with no leading zeroes.
+ * 
+ * @param The divisor, which must not be zero.
  * 
- * @param The divisor.
+ * @param A container which receives the remainder, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+void abs_val_divmod(container_t& outNum, const container_t& inNum, container_t& remainder);
+
+
+
+/**
+ * Divide one number by the second parameter, discarding the remainder.
+ * 
+ * @see abs_val_divmod()
  */
 template <typename limits_t, typename container_t>
 void abs_val_div(container_t& outNum, const container_t& inNum);
 
 
 
+/**
+ * Divide a number by a native integer, in-place.
+ * 
+ * @param The container which will hold the quotient.
+ * 
+ * @param A divisor which must be non-zero and no greater than 2^32.
+ * 
+ * @return The remainder of the division.
+ */
+template <typename limits_t, typename container_t>
+bn_u64_t abs_val_div_small(container_t& num, bn_u64_t divisor);
+
+
+
+/**
+ * Divide a number by any 64-bit native integer, in-place. Divisors of up to
+ * 2^32 are passed to abs_val_div_small(), while larger ones are split into
+ * digits and divided through abs_val_divmod().
+ * 
+ * @param The container which will hold the quotient.
+ * 
+ * @param A non-zero native integer divisor.
+ * 
+ * @return The remainder of the division.
+ */
+template <typename limits_t, typename container_t>
+bn_u64_t abs_val_div_native(container_t& num, bn_u64_t divisor);
+
+
+
+/**
+ * @return The high 64 bits of the 128-bit product of two integers.
+ */
+inline bn_u64_t bn_mul_high(bn_u64_t a, bn_u64_t b);
+
+
+
+/**
+ * Divide a number by a native integer, in-place, using a precomputed
+ * inverse in place of a hardware division for each digit.
+ * 
+ * @param The container which will hold the quotient.
+ * 
+ * @param A divisor which must be non-zero and no greater than 2^32.
+ * 
+ * @param The inverse of the divisor, (2^64-1) / divisor.
+ * 
+ * @return The remainder of the division.
+ */
+template <typename limits_t, typename container_t>
+bn_u64_t abs_val_div_small_preinv(container_t& num, bn_u64_t divisor, bn_u64_t inverse);
+
+
+
+/**
+ * @return The greatest common divisor of two integers.
+ */
+inline bn_u64_t bn_gcd(bn_u64_t a, bn_u64_t b);
+
+
+
+/**
+ * @return The inverse of a number modulo another, with which it must share
+ * no common factor.
+ */
+inline bn_u64_t bn_mod_inverse(bn_u64_t num, bn_u64_t modulus);
+
+
+
+/**
+ * Exact division by Hensel's method, producing one quotient digit per step
+ * from the lowest digit of the remainder and the inverse of the lowest digit
+ * of the divisor. No quotient digits need to be estimated or corrected.
+ * 
+ * The lowest digit of the divisor must share no common factor with the
+ * numerical base. Only the lowest qLen digits of either operand are read,
+ * and the quotient is written over the lowest qLen digits of u. The
+ * quotient is only meaningful if the divisor divides the dividend.
+ */
+template <typename limits_t, typename container_t>
+void divexact_kernel(
+    bn_iter_t<container_t> u, bn_size_t<container_t> qLen,
+    bn_citer_t<container_t> v, bn_size_t<container_t> vLen,
+    bn_u64_t vInverse
+);
+
+
+
+/**
+ * Shortest quotient for which exact division is split in halves.
+ */
+constexpr std::size_t BN_EXACT_MIN_LEN = 8;
+
+
+
+/**
+ * Exact division, following Jebelean's method, with the same arguments as
+ * divexact_kernel(). Quotients of at least BNThresholds::divExact digits
+ * are split in halves. The low half is found first, then its product with
+ * the divisor is removed from the dividend to find the high half.
+ */
+template <typename limits_t, typename container_t>
+void divexact_split(
+    bn_iter_t<container_t> u, bn_size_t<container_t> qLen,
+    bn_citer_t<container_t> v, bn_size_t<container_t> vLen,
+    bn_u64_t vInverse
+);
+
+
+
+/**
+ * Divide a number, in-place, by a divisor which is known to divide it with
+ * no remainder, using divexact_split(). This is cheaper than abs_val_div(),
+ * and short quotients need no memory beyond their own. Divisors whose
+ * lowest non-zero digit shares a factor with the numerical base are copied
+ * and divided by that factor first.
+ * 
+ * If the division is not exact, the quotient is meaningless, and an
+ * assertion fails when BN_DEBUG is defined.
+ * 
+ * @param The container which will hold the quotient.
+ * 
+ * @param A non-zero divisor.
+ */
+template <typename limits_t, typename container_t>
+void abs_val_divexact(container_t& num, const container_t& divisor);
+
+
+
 #include "bignum/impl/bn_division_impl.h"
 
 
@@ -0,0 +1,141 @@
+/* 
+ * File:   bn_divisor.h
+ */
+
+#ifndef __BN_DIVISOR_H__
+#define	__BN_DIVISOR_H__
+
+#include <utility>
+
+#include "bignum/bn_setup.h"
+#include "bignum/bn_limits.h"
+#include "bignum/bn_type.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//          Classes
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Constant Divisor Class
+ * 
+ * Holds a divisor which many other numbers are divided by, along with the
+ * values needed to replace each division with multiplications. A
+ * single-digit divisor stores a 64-bit inverse. Longer divisors store their
+ * normalizing scale and, once they reach BNThresholds::divBarrett digits,
+ * their reciprocal.
+ * 
+ * @note
+ * Everything is computed on construction, so instances can be shared between
+ * threads once they are built.
+ * 
+ * @param limits_t
+ * Any class specialization of the bn_limits_t structure.
+ * 
+ * @param container_t
+ * A container which contains the union of members and methods found in between
+ * an std::vector and std::deque.
+ */
+template <class limits_t, class container_t>
+class BignumDivisor final {
+    public:
+        /**
+         * Type of the numbers which can be divided
+         */
+        typedef Bignum<limits_t, container_t> bignum_type;
+    
+    /*
+     * Private member information
+     */
+    private:
+        bignum_type divisor;
+        bn_u64_t scale = 1;
+        bn_u64_t inverse = 0;
+        container_t normalized;
+        container_t reciprocal;
+        
+        /**
+         * Compute the inverse, or the scale, normalized divisor and
+         * reciprocal, of the divisor.
+         */
+        void prepare();
+    
+    /*
+     * Public member information
+     */
+    public:
+        /**
+         * Constructor
+         * 
+         * @param The divisor which other numbers will be divided by.
+         */
+        explicit BignumDivisor(const bignum_type&);
+        
+        /**
+         * Move constructor for a divisor
+         * 
+         * @param The divisor which other numbers will be divided by.
+         */
+        explicit BignumDivisor(bignum_type&&);
+        
+        /**
+         * Copy Constructor
+         */
+        BignumDivisor(const BignumDivisor&) = default;
+        
+        /**
+         * Move Constructor
+         */
+        BignumDivisor(BignumDivisor&&) = default;
+        
+        /**
+         * Destructor
+         */
+        ~BignumDivisor() = default;
+        
+        /**
+         * Copy Operator
+         */
+        BignumDivisor& operator=(const BignumDivisor&) = default;
+        
+        /**
+         * Move Operator
+         */
+        BignumDivisor& operator=(BignumDivisor&&) = default;
+        
+        /**
+         * @return The divisor held by *this.
+         */
+        const bignum_type& getDivisor() const;
+        
+        /**
+         * Division
+         * 
+         * @param A bignum which will be divided by the divisor.
+         * 
+         * @return The quotient, truncated towards zero, with the same special
+         * values as Bignum::divmod().
+         */
+        bignum_type divide(const bignum_type&) const;
+        
+        /**
+         * Modulus
+         * 
+         * @param A bignum which will be divided by the divisor.
+         * 
+         * @return The remainder, which takes the sign of the input number.
+         */
+        bignum_type mod(const bignum_type&) const;
+        
+        /**
+         * Division with remainder
+         * 
+         * @param A bignum which will be divided by the divisor.
+         * 
+         * @return A pair containing the quotient and the remainder, matching
+         * those of Bignum::divmod().
+         */
+        std::pair<bignum_type, bignum_type> divmod(const bignum_type&) const;
+};
+
+#include "bignum/impl/bn_divisor_impl.h"
+
+#endif	/* __BN_DIVISOR_H__ */
@@ -125,6 +125,17 @@ constexpr bn_u64_t bn_min_limit<BN_UINT64>();
 template<>
 constexpr bn_u64_t bn_max_limit<BN_UINT64>();
 
+///////////////////////////////////////////////////////////////////////////////
+// Bit counting
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Count the number of bits required to represent an integer.
+ * 
+ * @return The position of the highest set bit, plus one. Zero is returned if
+ * the input is zero.
+ */
+constexpr bn_u64_t bn_bit_width(bn_u64_t n);
+
 #include "bignum/impl/bn_limits_impl.h"
 
 
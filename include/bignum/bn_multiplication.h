@@ -8,22 +8,219 @@
 #ifndef __BN_MULTIPLICATION_H__
 #define	__BN_MULTIPLICATION_H__
 
+#include "bignum/bn_thresholds.h"
+#include "bignum/fourier.h"
+#include "bignum/ntt.h"
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Digit-iterator typedefs
+///////////////////////////////////////////////////////////////////////////////
+template <typename container_t>
+using bn_iter_t = typename container_t::iterator;
+
+template <typename container_t>
+using bn_citer_t = typename container_t::const_iterator;
+
+template <typename container_t>
+using bn_size_t = typename container_t::size_type;
+
+
+
+/**
+ * Multiply two numbers, selecting the fastest algorithm for the length of
+ * each operand based on the thresholds in BNThresholds<limits_t>.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @return The product of both input numbers, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t abs_val_mul(const container_t& a, const container_t& b);
+
+
+
+/**
+ * Square a number, selecting the fastest algorithm for its length. Squaring
+ * kernels only read one operand, which saves roughly a third of the work of
+ * a general multiplication.
+ * 
+ * @param A container, managed by a container_t_t class, which will be squared.
+ * 
+ * @return The square of the input number, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t abs_val_sqr(const container_t& a);
+
+
+
+/**
+ * Multiply a number by a native integer, in-place.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A factor which must be no greater than 2^32.
+ */
+template <typename limits_t, typename container_t>
+void abs_val_mul_small(container_t& num, bn_u64_t factor);
+
+
+
+/**
+ * Multiply a number by any 64-bit native integer, in-place. Factors of up to
+ * 2^32 are passed to abs_val_mul_small(), while larger ones are split into
+ * digits and multiplied through abs_val_mul().
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A native integer factor.
+ */
+template <typename limits_t, typename container_t>
+void abs_val_mul_native(container_t& num, bn_u64_t factor);
+
 
 
 /**
  * Perform multiplication on two numbers using an FFT and return their product.
  * 
+ * Digits of a power-of-two base are split into bit fields of 8 bits or more
+ * when needed to keep rounding exact. Products are only guaranteed to be
+ * exact when fft_num_pieces() returns a non-zero count for the operands.
+ * 
  * @param A container, managed by a container_t_t class, which will be multiplied.
  * 
  * @param A container, managed by a container_t_t class, which will be multiplied.
  * 
  * @return The product of both input numbers.
  */
-template <typename limits_t, typename container_t>
+template <typename limits_t, typename container_t, typename flt_t = double>
 container_t mul_strassen(const container_t& a, const container_t& b);
 
 
 
+/**
+ * Square a number using a single real-valued FFT, packed into a complex
+ * transform of half the length used by mul_strassen().
+ * 
+ * @param A container, managed by a container_t_t class, which will be squared.
+ * 
+ * @return The square of the input number.
+ */
+template <typename limits_t, typename container_t, typename flt_t = double>
+container_t sqr_strassen(const container_t& a);
+
+
+
+/**
+ * Multiply a number by another whose transform was precomputed by
+ * fft_real_spectrum(). Only one forward and one inverse transform are run,
+ * each half the length of those used by mul_strassen().
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param The spectrum of the other factor. Its length must match
+ * fft_real_length() for the product, with digits split into numPieces fields.
+ * 
+ * @param The number of fields each digit of both factors is split into.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t, typename flt_t = double>
+container_t mul_strassen_spectrum(
+    const container_t& a,
+    const BNRealSpectrum<flt_t>& b,
+    unsigned numPieces
+);
+
+
+
+/**
+ * Multiply a long number by a much shorter one using an FFT. The longer
+ * operand is split into chunks which fill a transform about twice the
+ * length of the shorter operand. The shorter operand is only transformed
+ * once, and the product of each chunk is added in at its offset.
+ * 
+ * Products are exact under the same conditions as mul_strassen().
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be
+ * multiplied. It must not be longer than the first operand.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t, typename flt_t = double>
+container_t mul_strassen_unbalanced(const container_t& a, const container_t& b);
+
+
+
+/**
+ * Multiply a long number in chunks by another whose transform was
+ * precomputed by fft_real_spectrum(), as in mul_strassen_unbalanced().
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param The number of digits in the other factor.
+ * 
+ * @param The spectrum of the other factor. Its length must be at least
+ * fft_real_length() for twice the length of that factor, with digits split
+ * into numPieces fields. Each chunk fills the rest of its length.
+ * 
+ * @param The number of fields each digit of both factors is split into.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t, typename flt_t = double>
+container_t mul_strassen_spectrum_unbalanced(
+    const container_t& a,
+    bn_size_t<container_t> bLen,
+    const BNRealSpectrum<flt_t>& b,
+    unsigned numPieces
+);
+
+
+
+/**
+ * Perform multiplication on two numbers using a number-theoretic transform
+ * and return their product.
+ * 
+ * Unlike mul_strassen(), the convolution is computed exactly using integer
+ * transforms modulo word-sized primes which are recombined with the Chinese
+ * Remainder Theorem. Products are exact for operands of any length and any
+ * numerical base.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t>
+container_t mul_ntt(const container_t& a, const container_t& b);
+
+
+
+/**
+ * Perform mul_ntt() with transforms of at most "maxLen" points. Longer
+ * products are computed by splitting the longer operand in halves, which
+ * also happens for operands too long for the available primes.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param The longest transform which may be used.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t>
+container_t mul_ntt_split(const container_t& a, const container_t& b, ntt_size_t maxLen);
+
+
+
 /**
  * Perform multiplication on two numbers and return their product.
  * 
@@ -38,6 +235,309 @@ container_t mul_naive(const container_t& a, const container_t& b);
 
 
 
+/**
+ * Square a number by computing each cross product only once.
+ * 
+ * @param A container, managed by a container_t_t class, which will be squared.
+ * 
+ * @return The square of the input number.
+ */
+template <typename limits_t, typename container_t>
+container_t sqr_naive(const container_t& a);
+
+
+
+/**
+ * Perform multiplication on two numbers using Karatsuba's method and return
+ * their product. Operands shorter than BNThresholds<limits_t>::mulKaratsuba
+ * are multiplied using the schoolbook method.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t>
+container_t mul_karatsuba(const container_t& a, const container_t& b);
+
+
+
+/**
+ * Square a number using Karatsuba's method. Operands shorter than
+ * BNThresholds<limits_t>::sqrKaratsuba are squared using sqr_naive().
+ * 
+ * @param A container, managed by a container_t_t class, which will be squared.
+ * 
+ * @return The square of the input number.
+ */
+template <typename limits_t, typename container_t>
+container_t sqr_karatsuba(const container_t& a);
+
+
+
+/**
+ * Perform multiplication on two numbers using the Toom-Cook 3-way method
+ * and return their product.
+ * 
+ * Each operand is split into three parts which are evaluated at the points
+ * 0, 1, -1, -2 and infinity. The five pointwise products are computed using
+ * abs_val_mul(), then interpolated using Bodrato's sequence.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t>
+container_t mul_toom3(const container_t& a, const container_t& b);
+
+
+
+/**
+ * Perform multiplication on two numbers using the Toom-Cook 4-way method
+ * and return their product.
+ * 
+ * Each operand is split into four parts which are evaluated at the points
+ * 0, 1, -1, 2, -2, 3 and infinity. The seven pointwise products are computed
+ * using abs_val_mul(), then interpolated.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @param A container, managed by a container_t_t class, which will be multiplied.
+ * 
+ * @return The product of both input numbers.
+ */
+template <typename limits_t, typename container_t>
+container_t mul_toom4(const container_t& a, const container_t& b);
+
+
+
+/**
+ * Shortest operand which mul_toom3() and mul_toom4() split into parts.
+ * Shorter operands are multiplied with Karatsuba's method, as the parts of
+ * a shorter operand, once evaluated, can be as long as the operand itself,
+ * and would never stop recursing.
+ */
+constexpr std::size_t BN_TOOM_MIN_LEN = 16;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Toom-Cook helpers
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Signed intermediate value used while evaluating and interpolating the
+ * Toom-Cook polynomials. The magnitude never contains leading zeroes and a
+ * value of zero is never negative.
+ */
+template <typename container_t>
+struct BNToomValue {
+    bool negative;
+    container_t digits;
+};
+
+/**
+ * Add one signed value to another, in-place.
+ */
+template <typename limits_t, typename container_t>
+void toom_add(BNToomValue<container_t>& x, const BNToomValue<container_t>& y);
+
+/**
+ * Subtract one signed value from another, in-place.
+ */
+template <typename limits_t, typename container_t>
+void toom_sub(BNToomValue<container_t>& x, const BNToomValue<container_t>& y);
+
+/**
+ * Multiply a signed value by a small native integer, in-place.
+ */
+template <typename limits_t, typename container_t>
+void toom_mul_small(BNToomValue<container_t>& x, bn_u64_t factor);
+
+/**
+ * Divide a signed value by a small native integer which is known to divide
+ * it exactly, in-place.
+ */
+template <typename limits_t, typename container_t>
+void toom_div_exact(BNToomValue<container_t>& x, bn_u64_t divisor);
+
+/**
+ * @return The product of two signed values.
+ */
+template <typename limits_t, typename container_t>
+BNToomValue<container_t> toom_mul(const BNToomValue<container_t>& x, const BNToomValue<container_t>& y);
+
+/**
+ * Evaluate the product polynomial at base^k, given all of its coefficients.
+ * Every coefficient must be non-negative.
+ */
+template <typename limits_t, typename container_t>
+container_t toom_recompose(const BNToomValue<container_t>* coeffs, unsigned numCoeffs, bn_size_t<container_t> k);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiplication kernels
+// 
+// These operate on ranges of digits, ordered from least to most significant,
+// and never allocate memory. Output ranges must not overlap their inputs.
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Add two ranges of digits. The output range must hold max(xLen, yLen)+1
+ * digits.
+ */
+template <typename limits_t, typename container_t>
+void bn_digits_add(
+    bn_citer_t<container_t> x, bn_size_t<container_t> xLen,
+    bn_citer_t<container_t> y, bn_size_t<container_t> yLen,
+    bn_iter_t<container_t> out
+);
+
+/**
+ * Add a range of digits into another. The sum must fit within xLen digits.
+ */
+template <typename limits_t, typename container_t>
+void bn_digits_add_in_place(
+    bn_iter_t<container_t> x, bn_size_t<container_t> xLen,
+    bn_citer_t<container_t> y, bn_size_t<container_t> yLen
+);
+
+/**
+ * Subtract a range of digits from another. The value of the first range must
+ * be greater than or equal to the second.
+ */
+template <typename limits_t, typename container_t>
+void bn_digits_sub_in_place(
+    bn_iter_t<container_t> x, bn_size_t<container_t> xLen,
+    bn_citer_t<container_t> y, bn_size_t<container_t> yLen
+);
+
+/**
+ * Schoolbook multiplication by product scanning (Comba's method), which
+ * produces each output digit from the full sum of its column of products.
+ * Writes exactly (aLen+bLen) digits to the output, which must not overlap
+ * either operand.
+ */
+template <typename limits_t, typename container_t>
+void mul_schoolbook_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_citer_t<container_t> b, bn_size_t<container_t> bLen,
+    bn_iter_t<container_t> out
+);
+
+/**
+ * Schoolbook squaring by product scanning. Only the upper triangle of cross
+ * products is computed, then doubled and added to the squares of each digit.
+ * Writes exactly (2*aLen) digits to the output, which must not overlap the
+ * operand.
+ */
+template <typename limits_t, typename container_t>
+void sqr_schoolbook_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_iter_t<container_t> out
+);
+
+/**
+ * Longest operand which the schoolbook kernels pass to bn_column_sums() and
+ * bn_column_squares() at once. Longer operands are processed in blocks.
+ */
+constexpr std::size_t BN_COLUMN_BLOCK_LEN = 64;
+
+/**
+ * Shortest operand which the schoolbook kernels pass to bn_column_sums() and
+ * bn_column_squares(). Below this, copying the digits into blocks costs more
+ * than it saves.
+ */
+constexpr std::size_t BN_COLUMN_MIN_LEN = 16;
+
+/**
+ * Sum the columns of the schoolbook product of two blocks of digits. Column
+ * k receives the sum of x[i]*y[k-i] over every valid i, for k below
+ * (xLen+yLen-1). yRev holds the digits of y in reverse order, so every
+ * column is a contiguous dot product.
+ * 
+ * Products of digits wider than 16 bits are split by the base of digit_t,
+ * with their low digit added to lo[k] and their high digit added to hi[k].
+ * Narrower products are added to lo[k] whole, leaving hi[k] at 0.
+ * 
+ * The 16- and 32-bit overloads use the instruction set selected by
+ * fft_set_simd_level().
+ */
+template <typename digit_t>
+void bn_column_sums(
+    const digit_t* x, std::size_t xLen,
+    const digit_t* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+);
+
+void bn_column_sums(
+    const BN_UINT16* x, std::size_t xLen,
+    const BN_UINT16* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+);
+
+void bn_column_sums(
+    const BN_UINT32* x, std::size_t xLen,
+    const BN_UINT32* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+);
+
+/**
+ * Sum the columns of the schoolbook square of a block of digits, in the same
+ * form as bn_column_sums(). Each cross product x[i]*x[k-i] with i < k-i is
+ * computed once and doubled, then the square of x[k/2] is added to every
+ * even column. xRev holds the digits of x in reverse order.
+ */
+template <typename digit_t>
+void bn_column_squares(
+    const digit_t* x, const digit_t* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+);
+
+void bn_column_squares(
+    const BN_UINT16* x, const BN_UINT16* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+);
+
+void bn_column_squares(
+    const BN_UINT32* x, const BN_UINT32* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+);
+
+/**
+ * @return The number of scratch digits required by mul_karatsuba_kernel()
+ * and sqr_karatsuba_kernel() for operands of up to "len" digits.
+ */
+template <typename container_t>
+bn_size_t<container_t> mul_karatsuba_scratch(bn_size_t<container_t> len);
+
+/**
+ * Karatsuba multiplication. Writes exactly (aLen+bLen) digits to the output.
+ * The scratch range must hold mul_karatsuba_scratch(max(aLen, bLen)) digits.
+ */
+template <typename limits_t, typename container_t>
+void mul_karatsuba_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_citer_t<container_t> b, bn_size_t<container_t> bLen,
+    bn_iter_t<container_t> out,
+    bn_iter_t<container_t> scratch
+);
+
+/**
+ * Karatsuba squaring. Writes exactly (2*aLen) digits to the output. The
+ * scratch range must hold mul_karatsuba_scratch(aLen) digits.
+ */
+template <typename limits_t, typename container_t>
+void sqr_karatsuba_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_iter_t<container_t> out,
+    bn_iter_t<container_t> scratch
+);
+
+
+
 #include "bignum/impl/bn_multiplication_impl.h"
 
 
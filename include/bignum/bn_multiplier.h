@@ -0,0 +1,128 @@
+/* 
+ * File:   bn_multiplier.h
+ */
+
+#ifndef __BN_MULTIPLIER_H__
+#define	__BN_MULTIPLIER_H__
+
+#include "bignum/bn_setup.h"
+#include "bignum/bn_limits.h"
+#include "bignum/bn_type.h"
+#include "bignum/fourier.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//          Classes
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Constant Factor Class
+ * 
+ * Holds a factor which is multiplied against many other numbers, along with
+ * its transform. Each FFT-sized multiplication then only transforms the
+ * other operand.
+ * 
+ * @note
+ * The transform is computed on first use and rebuilt whenever a product
+ * needs a different transform length. Products with the same number of
+ * digits share a single transform, as do numbers long enough to be
+ * multiplied in chunks by mul_strassen_spectrum_unbalanced(). Instances are
+ * not safe to share between threads without external locking.
+ * 
+ * @param limits_t
+ * Any class specialization of the bn_limits_t structure.
+ * 
+ * @param container_t
+ * A container which contains the union of members and methods found in between
+ * an std::vector and std::deque.
+ */
+template <class limits_t, class container_t>
+class BignumMultiplier final {
+    public:
+        /**
+         * Type of the numbers which can be multiplied
+         */
+        typedef Bignum<limits_t, container_t> bignum_type;
+    
+    /*
+     * Private member information
+     */
+    private:
+        bignum_type factor;
+        unsigned numPieces = 0;
+        BNRealSpectrum<double> spectrum;
+        
+        /**
+         * Rebuild the transform of the factor if it does not suit a product
+         * with a number of numDigits digits. Chunked products use a
+         * transform of twice the length of the factor.
+         * 
+         * @return FALSE if the product cannot be computed exactly with a
+         * floating-point transform.
+         */
+        bool prepare(typename container_t::size_type numDigits, bool chunked);
+    
+    /*
+     * Public member information
+     */
+    public:
+        /**
+         * Constructor
+         * 
+         * @param The factor which will be multiplied against other numbers.
+         */
+        explicit BignumMultiplier(const bignum_type&);
+        
+        /**
+         * Move constructor for a factor
+         * 
+         * @param The factor which will be multiplied against other numbers.
+         */
+        explicit BignumMultiplier(bignum_type&&);
+        
+        /**
+         * Copy Constructor
+         */
+        BignumMultiplier(const BignumMultiplier&) = default;
+        
+        /**
+         * Move Constructor
+         */
+        BignumMultiplier(BignumMultiplier&&) = default;
+        
+        /**
+         * Destructor
+         */
+        ~BignumMultiplier() = default;
+        
+        /**
+         * Copy Operator
+         */
+        BignumMultiplier& operator=(const BignumMultiplier&) = default;
+        
+        /**
+         * Move Operator
+         */
+        BignumMultiplier& operator=(BignumMultiplier&&) = default;
+        
+        /**
+         * @return The factor held by *this.
+         */
+        const bignum_type& getFactor() const;
+        
+        /**
+         * Free the cached transform of the factor.
+         */
+        void clearCache();
+        
+        /**
+         * Multiplication
+         * 
+         * @param A bignum which will be multiplied by the factor.
+         * 
+         * @return The product of the input number and the factor.
+         */
+        bignum_type multiply(const bignum_type&);
+};
+
+#include "bignum/impl/bn_multiplier_impl.h"
+
+#endif	/* __BN_MULTIPLIER_H__ */
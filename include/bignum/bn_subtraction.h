@@ -27,6 +27,15 @@ template <typename limits_t, typename container_t>
 void abs_val_sub(container_t& largerNum, const container_t& smallerNum);
 
 
+/**
+ * Remove all zeroes from the most-significant end of a number.
+ * 
+ * @param The container whose leading zeroes should be removed.
+ */
+template <typename container_t>
+void abs_val_trim(container_t& num);
+
+
 
 #include "bignum/impl/bn_subtraction_impl.h"
 
@@ -0,0 +1,155 @@
+/* 
+ * File:   bn_thresholds.h
+ */
+
+#ifndef __BN_THRESHOLDS_H__
+#define	__BN_THRESHOLDS_H__
+
+#include <cstddef>
+#include <iosfwd>
+
+#include "bignum/bn_setup.h"
+#include "bignum/bn_limits.h"
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Algorithm selection thresholds
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Operand lengths, in digits, at which the arithmetic routines of a bignum
+ * switch from one algorithm to another.
+ * 
+ * The best crossover points depend on both the machine and the numerical base
+ * of a bignum, so each limits_t has its own set of thresholds. They may be
+ * modified at runtime, but not while other threads are performing arithmetic.
+ * 
+ * @param limits_t
+ * Any class specialization of the bn_limits_t structure.
+ */
+template <typename limits_t>
+struct BNThresholds {
+    /**
+     * Length of the shorter operand at which multiplication switches from
+     * the schoolbook method to Karatsuba's method.
+     */
+    static std::size_t mulKaratsuba;
+
+    /**
+     * Length at which squaring switches from the schoolbook method to
+     * Karatsuba's method.
+     */
+    static std::size_t sqrKaratsuba;
+
+    /**
+     * Length of the shorter operand at which multiplication switches from
+     * Karatsuba's method to the Toom-Cook 3-way method. Only used below
+     * mulFFT, so the defaults never select Toom-Cook.
+     */
+    static std::size_t mulToom3;
+
+    /**
+     * Length of the shorter operand at which multiplication switches from
+     * the Toom-Cook 3-way method to the 4-way method.
+     */
+    static std::size_t mulToom4;
+
+    /**
+     * Length of the shorter operand at which multiplication switches to
+     * transform-based (FFT or NTT) methods.
+     */
+    static std::size_t mulFFT;
+
+    /**
+     * Length of the shorter operand at which transform-based multiplication
+     * splits a longer operand of at least 4 times its length into chunks,
+     * each multiplied against one transform of the shorter operand.
+     */
+    static std::size_t mulUnbalanced;
+
+    /**
+     * Length of both the divisor and the quotient at which division switches
+     * from long division to the recursive Burnikel-Ziegler method.
+     */
+    static std::size_t divBurnikel;
+
+    /**
+     * Length of both the divisor and the quotient at which division switches
+     * to multiplying by a reciprocal computed with Newton's method.
+     */
+    static std::size_t divNewton;
+
+    /**
+     * Length of a BignumDivisor, and of the quotient, at which it divides by
+     * a stored reciprocal.
+     */
+    static std::size_t divBarrett;
+
+    /**
+     * Length of the quotient at which exact division is split in halves,
+     * which are combined with a multiplication.
+     */
+    static std::size_t divExact;
+
+    // There is nothing in this class to instatiate
+    ~BNThresholds() = delete;
+    BNThresholds() = delete;
+    BNThresholds(const BNThresholds&) = delete;
+    BNThresholds(BNThresholds&&) = delete;
+    BNThresholds& operator=(const BNThresholds&) = delete;
+    BNThresholds& operator=(BNThresholds&&) = delete;
+};
+
+#include "bignum/impl/bn_thresholds_impl.h"
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Extern template declarations and typedefs
+///////////////////////////////////////////////////////////////////////////////
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_lowp, bn_limits_lowp);
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_medp, bn_limits_medp);
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_highp, bn_limits_highp);
+
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_base2, bn_limits_base2);
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_base8, bn_limits_base8);
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_base10, bn_limits_base10);
+BN_DECLARE_STRUCT(BNThresholds, bn_thresholds_base16, bn_limits_base16);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Threshold configuration files
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Read the thresholds of the built-in bignum types from a stream, such as
+ * one written by bn_save_thresholds() or the bn_tune utility.
+ * 
+ * Each line holds a single assignment of the form "highp.mulFFT = 256",
+ * naming the suffix of a built-in bignum typedef followed by a member of
+ * BNThresholds. Blank lines and anything following a '#' are ignored, as
+ * are thresholds which are not mentioned. Like any other change to the
+ * thresholds, this must not run while other threads perform arithmetic.
+ * 
+ * Values shorter than an algorithm supports, such as a Toom-Cook threshold
+ * below BN_TOOM_MIN_LEN, are rejected and leave their threshold unchanged.
+ * 
+ * @return FALSE if any line could not be parsed, named an unknown
+ * threshold, or held a rejected value. All valid lines are still applied.
+ */
+bool bn_load_thresholds(std::istream&);
+
+/**
+ * Read the thresholds of the built-in bignum types from a file.
+ * 
+ * @return FALSE if the file could not be opened or contained invalid lines.
+ */
+bool bn_load_thresholds(const char* fileName);
+
+/**
+ * Write the current thresholds of every built-in bignum type in the format
+ * read by bn_load_thresholds().
+ */
+void bn_save_thresholds(std::ostream&);
+
+#endif	/* __BN_THRESHOLDS_H__ */
@@ -12,6 +12,8 @@
 #include <iostream>
 #include <limits>
 #include <cassert>
+#include <type_traits>
+#include <utility>
 
 #include "bignum/bn_setup.h"
 #include "bignum/bn_limits.h"
@@ -411,6 +413,26 @@ class Bignum final {
          */
         Bignum operator * (const Bignum&) const;
 
+        /**
+         * Multiply by a single digit.
+         *
+         * @param A digit that will be multiplied into *this.
+         *
+         * @return A copy of *this, with the parameter value multiplied.
+         */
+        Bignum operator * (bn_single) const;
+
+        /**
+         * Multiply by an unsigned native integer.
+         *
+         * @param An unsigned integer that will be multiplied into *this.
+         *
+         * @return A copy of *this, with the parameter value multiplied.
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, Bignum>::type
+        operator * (int_t) const;
+
         /**
          * Divide.
          *
@@ -419,6 +441,59 @@ class Bignum final {
          * @return A copy of *this, divided by the input operand.
          */
         Bignum operator / (const Bignum&) const;
+
+        /**
+         * Modulo.
+         *
+         * @param A bignum that will be used to divide *this.
+         *
+         * @return The remainder of dividing *this by the input operand. It
+         * has the same sign as *this, matching the truncated division of
+         * native integers.
+         */
+        Bignum operator % (const Bignum&) const;
+
+        /**
+         * Divide by a single digit.
+         *
+         * @param A digit that will be used to divide *this.
+         *
+         * @return A copy of *this, divided by the input operand.
+         */
+        Bignum operator / (bn_single) const;
+
+        /**
+         * Divide by an unsigned native integer.
+         *
+         * @param An unsigned integer that will be used to divide *this.
+         *
+         * @return A copy of *this, divided by the input operand.
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, Bignum>::type
+        operator / (int_t) const;
+
+        /**
+         * Modulo by a single digit.
+         *
+         * @param A digit that will be used to divide *this.
+         *
+         * @return The remainder of dividing *this by the input operand, with
+         * the same sign as *this.
+         */
+        Bignum operator % (bn_single) const;
+
+        /**
+         * Modulo by an unsigned native integer.
+         *
+         * @param An unsigned integer that will be used to divide *this.
+         *
+         * @return The remainder of dividing *this by the input operand, with
+         * the same sign as *this.
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, Bignum>::type
+        operator % (int_t) const;
         
         /**
          * Add with assignment.
@@ -446,6 +521,29 @@ class Bignum final {
          * @return A reference to *this.
          */
         Bignum& operator *= (const Bignum&);
+
+        /**
+         * Multiplication by a single digit with assignment. The product is
+         * computed in-place, with one pass over the digits of *this.
+         *
+         * @param A digit that will be multiplied to *this.
+         *
+         * @return A reference to *this.
+         */
+        Bignum& operator *= (bn_single);
+
+        /**
+         * Multiplication by an unsigned native integer with assignment.
+         * Integers of up to 32 bits are multiplied in-place, with one pass
+         * over the digits of *this.
+         *
+         * @param An unsigned integer that will be multiplied to *this.
+         *
+         * @return A reference to *this.
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, Bignum&>::type
+        operator *= (int_t);
         
         /**
          * Division with assignment.
@@ -455,8 +553,157 @@ class Bignum final {
          * @return A reference to *this.
          */
         Bignum& operator /= (const Bignum&);
+
+        /**
+         * Modulo with assignment.
+         *
+         * @param A bignum that will divide *this.
+         *
+         * @return A reference to *this, holding the remainder of the
+         * division.
+         */
+        Bignum& operator %= (const Bignum&);
+
+        /**
+         * Division by a single digit with assignment. The quotient is
+         * computed in-place, with one pass over the digits of *this.
+         *
+         * @param A digit that will divide *this.
+         *
+         * @return A reference to *this.
+         */
+        Bignum& operator /= (bn_single);
+
+        /**
+         * Division by an unsigned native integer with assignment. Integers
+         * of up to 32 bits are divided in-place, with one pass over the
+         * digits of *this.
+         *
+         * @param An unsigned integer that will divide *this.
+         *
+         * @return A reference to *this.
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, Bignum&>::type
+        operator /= (int_t);
+
+        /**
+         * Modulo by a single digit with assignment.
+         *
+         * @param A digit that will divide *this.
+         *
+         * @return A reference to *this, holding the remainder of the
+         * division.
+         */
+        Bignum& operator %= (bn_single);
+
+        /**
+         * Modulo by an unsigned native integer with assignment.
+         *
+         * @param An unsigned integer that will divide *this.
+         *
+         * @return A reference to *this, holding the remainder of the
+         * division.
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, Bignum&>::type
+        operator %= (int_t);
+
+        /**
+         * Division with remainder. Both results come from a single pass of
+         * the long division, so this is cheaper than dividing and then
+         * taking the modulus.
+         *
+         * The quotient is truncated towards zero and the remainder takes the
+         * sign of *this. Dividing by zero produces an infinite quotient and
+         * a NaN remainder.
+         *
+         * @param A bignum that will divide *this.
+         *
+         * @param A bignum which receives the remainder. It may be *this or
+         * the divisor, in which case it is overwritten by the remainder once
+         * the division is done.
+         *
+         * @return A reference to *this, holding the quotient.
+         */
+        Bignum& divmod(const Bignum&, Bignum&);
+
+        /**
+         * Division by a single digit with remainder. *this receives the
+         * quotient in one pass over its digits, and nothing is allocated.
+         *
+         * Dividing by zero makes *this infinite and returns 0.
+         *
+         * @param A digit that will divide *this.
+         *
+         * @return The magnitude of the remainder, which takes the sign that
+         * *this had before the division.
+         */
+        bn_u64_t divmod_small(bn_single);
+
+        /**
+         * Division by an unsigned native integer with remainder.
+         *
+         * @param An unsigned integer that will divide *this.
+         *
+         * @return The magnitude of the remainder, which takes the sign that
+         * *this had before the division.
+         *
+         * @see divmod_small(bn_single)
+         */
+        template <typename int_t>
+        typename std::enable_if<std::is_unsigned<int_t>::value, bn_u64_t>::type
+        divmod_small(int_t);
+
+        /**
+         * Square.
+         *
+         * @return A copy of *this, multiplied by itself.
+         */
+        Bignum square() const;
+
+        /**
+         * Square in-place. This is faster than multiplying two different
+         * numbers of the same length.
+         *
+         * @return A reference to *this.
+         */
+        Bignum& sqr();
 };
 
+/**
+ * Divide two numbers, producing both their quotient and remainder.
+ *
+ * @param The dividend.
+ *
+ * @param The divisor.
+ *
+ * @return A pair containing the quotient and remainder, in that order.
+ *
+ * @see Bignum::divmod()
+ */
+template <class limits_t, class container_t>
+std::pair<Bignum<limits_t, container_t>, Bignum<limits_t, container_t>>
+divmod(const Bignum<limits_t, container_t>&, const Bignum<limits_t, container_t>&);
+
+/**
+ * Divide two numbers when the divisor is known to divide the dividend with
+ * no remainder, such as when removing a common factor. This is faster than
+ * the division operator, but the result is meaningless if the division is
+ * not exact. An assertion fails in that case if BN_DEBUG is defined.
+ *
+ * @param The dividend.
+ *
+ * @param The divisor.
+ *
+ * @return The quotient, with the same special values as operator/().
+ *
+ * @see abs_val_divexact()
+ */
+template <class limits_t, class container_t>
+Bignum<limits_t, container_t>
+divexact(const Bignum<limits_t, container_t>&, const Bignum<limits_t, container_t>&);
+
 #include "bignum/impl/bn_type_impl.h"
 
 #endif	/* __BIGNUM_TYPE_H__ */
@@ -8,23 +8,286 @@
 #ifndef __BN_FOURIER_H__
 #define	__BN_FOURIER_H__
 
+#include <algorithm>
+#include <cmath>
 #include <complex>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "bignum/bn_setup.h"
+#include "bignum/bn_except.h"
+#include "bignum/bn_limits.h"
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Complex signals
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * A list of complex numbers, stored as separate arrays of real and imaginary
+ * parts. This layout lets the transform process several butterflies with
+ * each vector instruction, rather than shuffling interleaved pairs.
+ * 
+ * @param flt_t
+ * Either float or double.
+ */
+template <typename flt_t>
+struct BNComplexList {
+    std::vector<flt_t> re;
+    std::vector<flt_t> im;
+
+    std::size_t size() const {
+        return re.size();
+    }
+
+    void resize(std::size_t len) {
+        re.resize(len, flt_t{0});
+        im.resize(len, flt_t{0});
+    }
+
+    std::complex<flt_t> get(std::size_t i) const {
+        return std::complex<flt_t>{re[i], im[i]};
+    }
+
+    void set(std::size_t i, const std::complex<flt_t>& c) {
+        re[i] = c.real();
+        im[i] = c.imag();
+    }
+};
+
+template <typename flt_t>
+using cmplx_list_t = BNComplexList<flt_t>;
+
+template <typename flt_t>
+using cmplx_size_t = std::size_t;
+
+template <typename flt_t>
+using cmplx_value_t = std::complex<flt_t>;
+
+template <typename flt_t>
+using cmplx_table_t = std::shared_ptr<const cmplx_list_t<flt_t>>;
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Vectorized butterfly kernels
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Instruction sets which may be used by the FFT butterflies.
+ */
+enum bn_simd_t : int {
+    BN_SIMD_NONE,
+    BN_SIMD_SSE2,
+    BN_SIMD_AVX2,
+    BN_SIMD_AVX512
+};
+
+/**
+ * @return The widest instruction set supported by both the compiler and the
+ * running CPU.
+ */
+bn_simd_t fft_simd_support();
+
+/**
+ * @return The instruction set currently used by fft_butterflies().
+ */
+bn_simd_t fft_simd_level();
+
+/**
+ * Select the instruction set used by fft_butterflies(). Requests for an
+ * unsupported instruction set fall back to the widest supported one.
+ */
+void fft_set_simd_level(bn_simd_t level);
+
+/**
+ * Apply one radix-2 pass of butterflies to a signal. Elements (i+k) and
+ * (i+k+span) are combined for each block of (2*span) elements, using the
+ * twiddle factor w[k] = exp(-pi*i*k/span).
+ * 
+ * Single- and double-precision overloads use the instruction set selected
+ * by fft_set_simd_level().
+ */
+void fft_butterflies(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span
+);
+
+void fft_butterflies(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span
+);
+
+/**
+ * Apply a strip of a radix-2 pass. Only the first "count" butterflies of
+ * each block of (2*span) elements are computed, so a pass with fewer blocks
+ * than threads can still be divided between them. To process butterflies k
+ * through (k+count-1), offset re, im, wRe, and wIm by k.
+ */
+void fft_butterflies(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+);
+
+void fft_butterflies(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+);
+
+/**
+ * Portable implementation of fft_butterflies().
+ */
+template <typename flt_t>
+void fft_butterflies_scalar(
+    flt_t* re, flt_t* im,
+    const flt_t* wRe, const flt_t* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Parallel transforms
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * A callable which runs task(i) for every i below numTasks, possibly on other
+ * threads, and returns once all of them have completed. Tasks may be run in
+ * any order.
+ */
+typedef std::function<void(std::size_t numTasks, const std::function<void(std::size_t)>& task)> bn_executor_t;
+
+/**
+ * @return The number of threads used for transforms of at least
+ * fft_parallel_length() values, including the calling thread.
+ */
+std::size_t fft_num_threads();
+
+/**
+ * Set the number of threads used for large transforms. A value of 0 (the
+ * default) uses one thread per hardware thread, while 1 keeps all transforms
+ * on the calling thread.
+ */
+void fft_set_num_threads(std::size_t numThreads);
+
+/**
+ * @return The length, in complex values, from which transforms and their
+ * point-wise products are divided between threads.
+ */
+std::size_t fft_parallel_length();
+
+/**
+ * Set the length from which transforms are divided between threads. Shorter
+ * transforms finish before the work could be handed out.
+ */
+void fft_set_parallel_length(std::size_t len);
+
+/**
+ * Run parallel transforms with an external executor rather than the
+ * library's own pool of threads. Transforms are still divided into
+ * fft_num_threads() tasks. Passing an empty function restores the built-in
+ * pool.
+ */
+void fft_set_executor(const bn_executor_t& executor);
+
+/**
+ * Run task(i) for every i below numTasks using the current executor, and
+ * return once all of them have completed. Jobs submitted from within a task,
+ * or while the built-in pool is busy with another thread's job, run on the
+ * calling thread.
+ */
+void fft_parallel_for(std::size_t numTasks, const std::function<void(std::size_t)>& task);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Transforms
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Find the shortest transform length which can hold a given number of
+ * values. Besides powers of 2, transforms may be 3 or 5 times a power of 2
+ * (of at least 4). Signals are then padded by at most a third of their
+ * length, rather than nearly doubled.
+ * 
+ * @param The number of values which must fit in the transform.
+ * 
+ * @return A length which is supported by fft_complex().
+ */
 template <typename flt_t>
-using cmplx_list_t = std::vector<std::complex<flt_t>>;
+cmplx_size_t<flt_t> fft_length(cmplx_size_t<flt_t> n);
 
+/**
+ * Retrieve the roots of unity (twiddle factors) for a transform of a given
+ * length. Tables are computed once per length, cached, and shared between
+ * all threads and between the forward and inverse transforms.
+ *
+ * @param The transform length, as returned by fft_length().
+ *
+ * @return A read-only table holding the twiddle factors of every radix-2
+ * butterfly pass, one after the other. The factors for a span of "s" start
+ * at index (s-1) and contain exp(-pi*i*k/s) for k < s. Entries from
+ * (len/2 - 1) up to (len - 1) are the first (len/2) roots of unity,
+ * exp(-2*pi*i*k/len), which are also the factors of the last pass when len
+ * is a power of 2.
+ * 
+ * Lengths of m*2^k, with m equal to 3 or 5, only have radix-2 passes with
+ * spans below 2^k. Their table is followed by (m-1) runs of 2^k factors,
+ * exp(-2*pi*i*r*k/len) for 0 < r < m, which join the radix-m pass.
+ */
 template <typename flt_t>
-using cmplx_size_t = typename cmplx_list_t<flt_t>::size_type;
+cmplx_table_t<flt_t> fft_roots(cmplx_size_t<flt_t> len);
 
+/**
+ * Release all cached twiddle-factor tables, along with the scratch space of
+ * the calling thread. Tables currently in use by other transforms remain
+ * valid until they complete.
+ */
 template <typename flt_t>
-using cmplx_value_t = typename cmplx_list_t<flt_t>::value_type;
+void fft_clear_roots();
+
+/**
+ * Longest scratch space, in complex values, which a thread keeps between
+ * transforms. Larger scratch space is released once its transform completes.
+ */
+constexpr std::size_t BN_FFT_SCRATCH_KEEP_LEN = std::size_t{1} << 20;
 
+/**
+ * Release the scratch space kept by the calling thread for the permutations
+ * of a transform. Other threads keep their own, of at most
+ * BN_FFT_SCRATCH_KEEP_LEN values.
+ */
+template <typename flt_t>
+void fft_clear_scratch();
 
+/**
+ * @return The length, in complex values, from which radix-2 transforms are
+ * computed with the four-step algorithm, or 0 if it is disabled.
+ */
+std::size_t fft_four_step_length();
+
+/**
+ * Set the length from which radix-2 transforms (including the blocks of
+ * mixed-radix transforms) use the four-step algorithm. Large transforms are
+ * then split into rows and columns which fit in cache, rather than streaming
+ * the whole signal from memory in every pass.
+ * 
+ * The four-step algorithm trades the later passes of a radix-2 transform for
+ * three matrix transposes, which only pays off where strided memory access
+ * is cheap relative to bandwidth. It is disabled (0) by default.
+ */
+void fft_set_four_step_length(std::size_t len);
+
+template <typename flt_t>
+void bit_reverse_permute(cmplx_list_t<flt_t>& x);
 
 template <typename flt_t>
 void fft_complex(cmplx_list_t<flt_t>& x);
@@ -32,12 +295,163 @@ void fft_complex(cmplx_list_t<flt_t>& x);
 template <typename flt_t>
 void ifft_complex(cmplx_list_t<flt_t>& x);
 
+/**
+ * Determine if a floating-point FFT convolution can be rounded back to exact
+ * integers.
+ * 
+ * Each convolution output is bounded by minLen*maxDigit^2, which takes at
+ * most 2*bit_width(maxDigit) + bit_width(minLen) bits. The rounding error of
+ * the transform is proportional to that bound times the unit roundoff of
+ * flt_t, and grows with the number of passes, log2(fftLen). The mantissa of
+ * flt_t must therefore also hold bit_width(bit_width(fftLen)) bits for the
+ * passes, plus 2 guard bits which keep the error well below the 1/2 at which
+ * rounding fails.
+ * 
+ * This bound is empirical rather than proven: proven bounds assume every
+ * rounding error adds up with the same sign, and would reject much shorter
+ * lengths. With every digit at maxDigit, which maximizes the outputs, the
+ * longest accepted lengths give errors of at most 0.02 in both float (4-bit
+ * digits, 512 of them) and double (16-bit digits, 8192 of them). That is a
+ * margin of more than 4 bits.
+ * 
+ * @param The largest value a single digit can hold.
+ * 
+ * @param The number of digits in the first operand.
+ * 
+ * @param The number of digits in the second operand.
+ * 
+ * @return TRUE if every output of the convolution can be recovered exactly,
+ * FALSE if otherwise.
+ */
+template <typename flt_t>
+bool fft_is_exact(bn_u64_t maxDigit, cmplx_size_t<flt_t> aLen, cmplx_size_t<flt_t> bLen);
+
+/**
+ * Floating-point type used for FFT multiplication by a given limits_t.
+ * 
+ * Digits of 4 bits or less (bases 2 through 16) are multiplied using single
+ * precision, which halves the memory of each transform and doubles the number
+ * of butterflies per vector instruction. Following fft_is_exact(), float
+ * transforms of balanced operands stay exact up to 32767 base-2 digits, 4095
+ * base-8 digits, and 1023 base-10 or base-16 digits. Longer products fall
+ * back to double precision, then to the number-theoretic transform.
+ */
+template <typename limits_t>
+using fft_float_t = typename std::conditional<(limits_t::SINGLE_BASE_MAX < 16), float, double>::type;
+
+/**
+ * Determine how finely the digits of a power-of-two base must be split for
+ * a floating-point FFT convolution to be exact.
+ * 
+ * Splitting every digit into smaller bit fields shrinks the largest value of
+ * each convolution output at the cost of a longer transform. Fields are never
+ * made smaller than 8 bits.
+ * 
+ * @param The largest value a single digit can hold.
+ * 
+ * @param The number of digits in the first operand.
+ * 
+ * @param The number of digits in the second operand.
+ * 
+ * @return The number of equally-sized fields each digit should be split
+ * into: 1 if whole digits are already exact, or 0 if no split is exact.
+ */
+template <typename flt_t>
+unsigned fft_num_pieces(bn_u64_t maxDigit, cmplx_size_t<flt_t> aLen, cmplx_size_t<flt_t> bLen);
+
+/**
+ * Pack two numbers into the real and imaginary parts of a single signal.
+ * 
+ * When numPieces is greater than 1, every digit is split into numPieces
+ * fields of pieceBits bits each, ordered from least to most significant.
+ */
 template <typename container_t, typename flt_t>
-cmplx_list_t<flt_t> create_fft_table(const container_t& a, const container_t& b);
+cmplx_list_t<flt_t> create_fft_table(
+    const container_t& a,
+    const container_t& b,
+    unsigned numPieces = 1,
+    unsigned pieceBits = 0
+);
 
 template <typename flt_t>
 void convolute_fft(cmplx_list_t<flt_t>& fftTable);
 
+/**
+ * Pack the digits of a single number into a table for squaring. Even digits
+ * are stored in the real parts and odd digits in the imaginary parts, so the
+ * table is half the length of the one made by create_fft_table(). Digits
+ * are split the same way as create_fft_table().
+ */
+template <typename container_t, typename flt_t>
+cmplx_list_t<flt_t> create_fft_sqr_table(
+    const container_t& a,
+    unsigned numPieces = 1,
+    unsigned pieceBits = 0
+);
+
+/**
+ * Transform a table from create_fft_sqr_table() and square it in the
+ * frequency domain. Running ifft_complex() on the result yields the even
+ * coefficients of the square in the real parts and the odd coefficients in
+ * the imaginary parts.
+ */
+template <typename flt_t>
+void convolute_fft_sqr(cmplx_list_t<flt_t>& fftTable);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Precomputed transforms of real-valued signals
+///////////////////////////////////////////////////////////////////////////////
+/**
+ * Spectra of the even and odd digits of a number, as recovered from a table
+ * packed by create_fft_real_table(). The second half of each spectrum holds
+ * the complex conjugates of the first, so only (fftSize/2 + 1) values of
+ * each are kept.
+ */
+template <typename flt_t>
+struct BNRealSpectrum {
+    cmplx_size_t<flt_t> fftSize = 0;
+    cmplx_list_t<flt_t> even;
+    cmplx_list_t<flt_t> odd;
+};
+
+/**
+ * @return The length of a packed real-valued table which can hold a product
+ * of productLen digits (or digit fields) without wrapping around.
+ */
+template <typename flt_t>
+cmplx_size_t<flt_t> fft_real_length(cmplx_size_t<flt_t> productLen);
+
+/**
+ * Pack the digits of a number into a table of fftSize complex values, with
+ * even digits in the real parts and odd digits in the imaginary parts.
+ * Digits are split the same way as create_fft_table().
+ */
+template <typename container_t, typename flt_t>
+cmplx_list_t<flt_t> create_fft_real_table(
+    const container_t& a,
+    cmplx_size_t<flt_t> fftSize,
+    unsigned numPieces = 1,
+    unsigned pieceBits = 0
+);
+
+/**
+ * Transform a table from create_fft_real_table() and keep the spectra of
+ * its even and odd digits. The table is overwritten in the process.
+ */
+template <typename flt_t>
+BNRealSpectrum<flt_t> fft_real_spectrum(cmplx_list_t<flt_t>& fftTable);
+
+/**
+ * Transform a table from create_fft_real_table() and multiply it by a
+ * spectrum of the same length in the frequency domain. Running
+ * ifft_complex() on the result yields the even coefficients of the product
+ * in the real parts and the odd coefficients in the imaginary parts.
+ */
+template <typename flt_t>
+void convolute_fft_spectrum(cmplx_list_t<flt_t>& fftTable, const BNRealSpectrum<flt_t>& spectrum);
+
 
 
 #include "bignum/impl/fourier_impl.h"
@@ -52,3 +52,49 @@ void abs_val_add(
         }
     }
 }
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Addition of a number which has been shifted by a number of digits.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+void abs_val_add_shifted(
+    container_t& outNum,
+    const container_t& inNum,
+    typename container_t::size_type shift
+) {
+    typedef typename limits_t::base_single bn_single;
+    typedef typename container_t::size_type big_size_type;
+
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    if (inNum.empty()) {
+        return;
+    }
+
+    // zero-pad the output so every input digit has a destination
+    if (outNum.size() < shift + inNum.size()) {
+        outNum.resize(shift + inNum.size(), bn_single{0});
+    }
+
+    bn_u64_t carry = 0;
+    big_size_type outIter = shift;
+
+    for (big_size_type inIter = 0; inIter < inNum.size(); ++inIter, ++outIter) {
+        carry += (bn_u64_t)outNum[outIter] + (bn_u64_t)inNum[inIter];
+        outNum[outIter] = (bn_single)(carry % NUM_BASE);
+        carry /= NUM_BASE;
+    }
+
+    // ripple any remaining carry into the higher digits
+    for (; carry; ++outIter) {
+        if (outIter == outNum.size()) {
+            outNum.push_back(bn_single{0});
+        }
+
+        carry += (bn_u64_t)outNum[outIter];
+        outNum[outIter] = (bn_single)(carry % NUM_BASE);
+        carry /= NUM_BASE;
+    }
+}
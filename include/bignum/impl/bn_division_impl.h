@@ -1,78 +1,911 @@
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Long division kernel
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void div_knuth_kernel(
+    bn_iter_t<container_t> u, bn_size_t<container_t> uLen,
+    bn_citer_t<container_t> v, bn_size_t<container_t> vLen,
+    bn_iter_t<container_t> q
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    BN_ASSERT(vLen >= 2 && uLen > vLen);
+    BN_ASSERT((bn_u64_t)v[vLen-1] >= NUM_BASE / 2);
+
+    const bn_u64_t vTop = (bn_u64_t)v[vLen-1];
+    const bn_u64_t vNext = (bn_u64_t)v[vLen-2];
+
+    for (bn_size_t<container_t> j = uLen - vLen; j --> 0;) {
+        // Estimate the quotient digit from the top two digits of the current
+        // remainder. With a normalized divisor, the estimate is at most two
+        // too large before this correction, and at most one too large after.
+        // (base-1)*base + (base-1) fits in 64 bits for bases up to 2^32.
+        const bn_u64_t top = (bn_u64_t)u[j+vLen] * NUM_BASE + (bn_u64_t)u[j+vLen-1];
+
+        bn_u64_t qHat = top / vTop;
+        bn_u64_t rHat = top % vTop;
+
+        while (qHat >= NUM_BASE || qHat * vNext > rHat * NUM_BASE + (bn_u64_t)u[j+vLen-2]) {
+            --qHat;
+            rHat += vTop;
+
+            if (rHat >= NUM_BASE) {
+                break;
+            }
+        }
+
+        // u[j..j+vLen] -= qHat * v
+        bn_u64_t carry = 0;
+        bn_u64_t borrow = 0;
+
+        for (bn_size_t<container_t> i = 0; i < vLen; ++i) {
+            const bn_u64_t product = qHat * (bn_u64_t)v[i] + carry;
+            const bn_u64_t sub = product % NUM_BASE + borrow;
+            const bn_u64_t digit = (bn_u64_t)u[i+j];
+
+            carry = product / NUM_BASE;
+            borrow = digit < sub;
+            u[i+j] = (bn_single)(digit + (borrow ? NUM_BASE : 0) - sub);
+        }
+
+        const bn_u64_t sub = carry + borrow;
+        const bn_u64_t digit = (bn_u64_t)u[j+vLen];
+
+        if (digit >= sub) {
+            u[j+vLen] = (bn_single)(digit - sub);
+        }
+        else {
+            // The estimate was one too large, so the divisor is added back.
+            // The final carry cancels the borrow, leaving a remainder which
+            // is shorter than the divisor.
+            --qHat;
+            carry = 0;
+
+            for (bn_size_t<container_t> i = 0; i < vLen; ++i) {
+                carry += (bn_u64_t)u[i+j] + (bn_u64_t)v[i];
+                u[i+j] = (bn_single)(carry % NUM_BASE);
+                carry /= NUM_BASE;
+            }
+
+            u[j+vLen] = bn_single{0};
+        }
+
+        q[j] = (bn_single)qHat;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Long division of normalized operands
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t div_knuth(
+    container_t& u,
+    const container_t& v
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    abs_val_trim<container_t>(u);
+
+    if (!abs_val_is_ge<container_t>(u, v)) {
+        return container_t{};
+    }
+
+    const bn_size_t<container_t> uLen = u.size();
+    const bn_size_t<container_t> vLen = v.size();
+
+    container_t q(uLen - vLen + 1, bn_single{0});
+
+    // The kernel expects an extra leading digit in the dividend
+    u.push_back(bn_single{0});
+    div_knuth_kernel<limits_t, container_t>(u.begin(), uLen+1, v.begin(), vLen, q.begin());
+
+    u.resize(vLen);
+    abs_val_trim<container_t>(u);
+    abs_val_trim<container_t>(q);
+
+    return q;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Newton reciprocal
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t div_newton_reciprocal(
+    bn_citer_t<container_t> v,
+    bn_size_t<container_t> vLen
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    const bn_size_t<container_t> k = vLen;
+    const container_t divisor(v, v + k);
+    container_t remainder{};
+
+    if (k < BN_NEWTON_MIN_LEN || k < BNThresholds<limits_t>::divNewton) {
+        container_t ret(2*k, bn_single{0});
+        ret.push_back(bn_single{1});
+        abs_val_divmod<limits_t, container_t>(ret, divisor, remainder);
+        return ret;
+    }
+
+    // Start from the reciprocal of the top half of the divisor, lowered so
+    // that it can never exceed the true reciprocal once it is shifted up.
+    // Every later step then only adds to the estimate.
+    const bn_size_t<container_t> h = (k + 1) / 2;
+    const bn_size_t<container_t> s = k - h;
+
+    container_t a = div_newton_reciprocal<limits_t, container_t>(v + s, h);
+    container_t four{};
+
+    for (bn_u64_t n = 4; n; n /= NUM_BASE) {
+        four.push_back((bn_single)(n % NUM_BASE));
+    }
+
+    abs_val_sub<limits_t, container_t>(a, four);
+
+    // e = base^(k+h) - v*a, which is the error of a*base^s divided by base^s
+    container_t e(k + h, bn_single{0});
+    e.push_back(bn_single{1});
+
+    container_t product = abs_val_mul<limits_t, container_t>(divisor, a);
+    abs_val_trim<container_t>(product);
+    abs_val_sub<limits_t, container_t>(e, product);
+
+    // One Newton step adds floor(a * e / base^(2h)). Only the top digits of
+    // the error are needed, and dropping the rest loses less than one unit.
+    container_t d{};
+
+    if (e.size() > h - 1) {
+        const container_t eTop(e.begin() + (h - 1), e.end());
+
+        d = abs_val_mul<limits_t, container_t>(a, eTop);
+
+        if (d.size() > h + 1) {
+            d.erase(d.begin(), d.begin() + (h + 1));
+            abs_val_trim<container_t>(d);
+        }
+        else {
+            d.clear();
+        }
+    }
+
+    container_t ret = d;
+    abs_val_add_shifted<limits_t, container_t>(ret, a, s);
+    abs_val_trim<container_t>(ret);
+
+    // The result is at most a few hundred units too small. The remaining
+    // error, base^(2k) - v*ret, is divided out using a single quotient digit
+    // or two of long division.
+    if (!e.empty()) {
+        e.insert(e.begin(), s, bn_single{0});
+    }
+
+    if (!d.empty()) {
+        product = abs_val_mul<limits_t, container_t>(divisor, d);
+        abs_val_trim<container_t>(product);
+        abs_val_sub<limits_t, container_t>(e, product);
+    }
+
+    if (abs_val_is_ge<container_t>(e, divisor)) {
+        abs_val_divmod<limits_t, container_t>(e, divisor, remainder);
+        abs_val_add<limits_t, container_t>(ret, e);
+    }
+
+    return ret;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Division by a stored reciprocal
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t div_reciprocal(
+    container_t& u,
+    const container_t& v,
+    const container_t& recip
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    abs_val_trim<container_t>(u);
+
+    const bn_size_t<container_t> m = v.size();
+    const bn_size_t<container_t> n = u.size();
+
+    BN_ASSERT(m >= 2);
+
+    if (!abs_val_is_ge<container_t>(u, v)) {
+        return container_t{};
+    }
+
+    const container_t one{bn_single{1}};
+
+    container_t q(n - m + 1, bn_single{0});
+    container_t r(u.begin() + (n - m + 1), u.end());
+
+    // Each block of up to m quotient digits comes from a partial dividend,
+    // t, of up to 2m digits. The estimate from the top m+1 digits of t never
+    // exceeds the quotient digit, and falls short by at most a few units.
+    for (bn_size_t<container_t> end = n - m + 1; end > 0;) {
+        const bn_size_t<container_t> start = (end > m) ? end - m : 0;
+
+        container_t t(u.begin() + start, u.begin() + end);
+        t.insert(t.end(), r.begin(), r.end());
+        abs_val_trim<container_t>(t);
+
+        container_t qBlock{};
+
+        if (t.size() > m - 1) {
+            const container_t tTop(t.begin() + (m - 1), t.end());
+
+            qBlock = abs_val_mul<limits_t, container_t>(tTop, recip);
+
+            if (qBlock.size() > m + 1) {
+                qBlock.erase(qBlock.begin(), qBlock.begin() + (m + 1));
+                abs_val_trim<container_t>(qBlock);
+            }
+            else {
+                qBlock.clear();
+            }
+        }
+
+        if (!qBlock.empty()) {
+            container_t product = abs_val_mul<limits_t, container_t>(qBlock, v);
+            abs_val_trim<container_t>(product);
+            abs_val_sub<limits_t, container_t>(t, product);
+        }
+
+        while (abs_val_is_ge<container_t>(t, v)) {
+            abs_val_sub<limits_t, container_t>(t, v);
+            abs_val_add<limits_t, container_t>(qBlock, one);
+        }
+
+        std::copy(qBlock.begin(), qBlock.end(), q.begin() + start);
+
+        r = std::move(t);
+        end = start;
+    }
+
+    u = std::move(r);
+    abs_val_trim<container_t>(q);
+
+    return q;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Newton division
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t div_newton(
+    container_t& u,
+    const container_t& v
+) {
+    const container_t recip = div_newton_reciprocal<limits_t, container_t>(v.begin(), v.size());
+    return div_reciprocal<limits_t, container_t>(u, v, recip);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Burnikel-Ziegler division
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t div_burnikel_2n1n(
+    container_t& a,
+    const container_t& b,
+    bn_size_t<container_t> n
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    if (n < BN_BURNIKEL_MIN_LEN || n < BNThresholds<limits_t>::divBurnikel) {
+        return div_knuth<limits_t, container_t>(a, b);
+    }
+
+    abs_val_trim<container_t>(a);
+
+    // Odd lengths are shifted up by a digit, which leaves the quotient alone
+    // and keeps the divisor normalized.
+    const bool padded = (n & 1) != 0;
+    container_t bPadded{};
+
+    if (padded) {
+        bPadded.push_back(bn_single{0});
+        bPadded.insert(bPadded.end(), b.begin(), b.end());
+
+        if (!a.empty()) {
+            a.insert(a.begin(), bn_single{0});
+        }
+
+        ++n;
+    }
+
+    const container_t& divisor = padded ? bPadded : b;
+    const bn_size_t<container_t> half = n / 2;
+    const bn_size_t<container_t> aLen = a.size();
+
+    const container_t b1(divisor.begin() + half, divisor.end());
+    container_t b2(divisor.begin(), divisor.begin() + half);
+    abs_val_trim<container_t>(b2);
+
+    // Split the dividend into four halves, [a1 a2 a3 a4]
+    container_t a12(a.begin() + (aLen < n ? aLen : n), a.end());
+    container_t a3(a.begin() + (aLen < half ? aLen : half), a.begin() + (aLen < n ? aLen : n));
+    container_t a4(a.begin(), a.begin() + (aLen < half ? aLen : half));
+
+    abs_val_trim<container_t>(a3);
+    abs_val_trim<container_t>(a4);
+
+    const container_t q1 = div_burnikel_3n2n<limits_t, container_t>(a12, a3, divisor, b1, b2, half);
+    container_t q = div_burnikel_3n2n<limits_t, container_t>(a12, a4, divisor, b1, b2, half);
+
+    abs_val_add_shifted<limits_t, container_t>(q, q1, half);
+    abs_val_trim<container_t>(q);
+
+    if (padded && !a12.empty()) {
+        a12.erase(a12.begin());
+    }
+
+    a = std::move(a12);
+
+    return q;
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t div_burnikel_3n2n(
+    container_t& a12,
+    const container_t& a3,
+    const container_t& b,
+    const container_t& b1,
+    const container_t& b2,
+    bn_size_t<container_t> n
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    container_t q{};
+    container_t aTop(a12.begin() + (a12.size() < n ? a12.size() : n), a12.end());
+    abs_val_trim<container_t>(aTop);
+
+    // When the top half of the dividend matches the top half of the divisor,
+    // the quotient would overflow n digits, and is instead set to its
+    // largest value.
+    if (aTop.size() == b1.size() && std::equal(aTop.begin(), aTop.end(), b1.begin())) {
+        q.assign(n, (bn_single)bn_u64_t{limits_t::SINGLE_BASE_MAX});
+
+        a12.resize(n);
+        abs_val_trim<container_t>(a12);
+        abs_val_add<limits_t, container_t>(a12, b1);
+    }
+    else {
+        q = div_burnikel_2n1n<limits_t, container_t>(a12, b1, n);
+    }
+
+    // r = r*base^n + a3 - q*b2, which is short of the true remainder by at
+    // most two multiples of the divisor.
+    container_t r = a3;
+    abs_val_add_shifted<limits_t, container_t>(r, a12, n);
+    abs_val_trim<container_t>(r);
+
+    container_t product = abs_val_mul<limits_t, container_t>(q, b2);
+    abs_val_trim<container_t>(product);
+
+    if (abs_val_is_ge<container_t>(r, product)) {
+        if (!product.empty()) {
+            abs_val_sub<limits_t, container_t>(r, product);
+        }
+    }
+    else {
+        const container_t one{bn_single{1}};
+
+        abs_val_sub<limits_t, container_t>(product, r);
+
+        for (;;) {
+            abs_val_sub<limits_t, container_t>(q, one);
+
+            if (abs_val_is_ge<container_t>(b, product)) {
+                r = b;
+                abs_val_sub<limits_t, container_t>(r, product);
+                break;
+            }
+
+            abs_val_sub<limits_t, container_t>(product, b);
+        }
+    }
+
+    a12 = std::move(r);
+
+    return q;
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t div_burnikel(
+    container_t& u,
+    const container_t& v
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    abs_val_trim<container_t>(u);
+
+    const bn_size_t<container_t> m = v.size();
+    const bn_size_t<container_t> n = u.size();
+
+    BN_ASSERT(m >= 2 && n >= m);
+
+    container_t q(n - m + 1, bn_single{0});
+    container_t r(u.begin() + (n - m + 1), u.end());
+
+    // Each block of up to m quotient digits comes from a partial dividend of
+    // up to 2m digits, which is less than the divisor times base^m.
+    for (bn_size_t<container_t> end = n - m + 1; end > 0;) {
+        const bn_size_t<container_t> start = (end > m) ? end - m : 0;
+
+        container_t t(u.begin() + start, u.begin() + end);
+        t.insert(t.end(), r.begin(), r.end());
+
+        const container_t qBlock = div_burnikel_2n1n<limits_t, container_t>(t, v, m);
+        std::copy(qBlock.begin(), qBlock.end(), q.begin() + start);
+
+        r = std::move(t);
+        end = start;
+    }
+
+    u = std::move(r);
+    abs_val_trim<container_t>(q);
+
+    return q;
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Division implementation of numbers with the same sign.
 ///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+void abs_val_divmod(
+    container_t& dividend,
+    const container_t& divisor,
+    container_t& remainder
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    container_t v = divisor;
+
+    abs_val_trim<container_t>(v);
+    abs_val_trim<container_t>(dividend);
+
+    const bn_size_t<container_t> vLen = v.size();
+
+    BN_ASSERT(vLen != 0);
+
+    if (!abs_val_is_ge<container_t>(dividend, v)) {
+        remainder = std::move(dividend);
+        dividend.clear();
+        return;
+    }
+
+    if (vLen == 1) {
+        const bn_u64_t rem = abs_val_div_small<limits_t, container_t>(dividend, (bn_u64_t)v[0]);
+
+        remainder.clear();
+
+        if (rem) {
+            remainder.push_back((bn_single)rem);
+        }
+
+        return;
+    }
+
+    // Normalize both operands so that the top digit of the divisor is at
+    // least half of the base. Scaling by a single digit works for any base,
+    // and never lengthens the divisor.
+    const bn_u64_t scale = NUM_BASE / ((bn_u64_t)v[vLen-1] + 1);
+
+    container_t u = std::move(dividend);
+    const bn_size_t<container_t> uLen = u.size();
+
+    abs_val_mul_small<limits_t, container_t>(v, scale);
+    abs_val_mul_small<limits_t, container_t>(u, scale);
+
+    const std::size_t newtonLen = (BNThresholds<limits_t>::divNewton > BN_NEWTON_MIN_LEN)
+        ? BNThresholds<limits_t>::divNewton
+        : BN_NEWTON_MIN_LEN;
+
+    const std::size_t burnikelLen = (BNThresholds<limits_t>::divBurnikel > BN_BURNIKEL_MIN_LEN)
+        ? BNThresholds<limits_t>::divBurnikel
+        : BN_BURNIKEL_MIN_LEN;
+
+    if (vLen >= newtonLen && uLen - vLen >= newtonLen) {
+        dividend = div_newton<limits_t, container_t>(u, v);
+    }
+    else if (vLen >= burnikelLen && uLen - vLen >= burnikelLen) {
+        dividend = div_burnikel<limits_t, container_t>(u, v);
+    }
+    else {
+        dividend = div_knuth<limits_t, container_t>(u, v);
+    }
+
+    // Every method leaves the remainder of the scaled operands, which is
+    // divided by the same scale with no remainder of its own.
+    abs_val_div_small<limits_t, container_t>(u, scale);
+    remainder = std::move(u);
+}
+
+
+
 template <class limits_t, class container_t>
 void abs_val_div(
     container_t& dividend,
     const container_t& divisor
+) {
+    container_t remainder;
+    abs_val_divmod<limits_t, container_t>(dividend, divisor, remainder);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// High half of a 64-bit product
+///////////////////////////////////////////////////////////////////////////////
+inline bn_u64_t bn_mul_high(bn_u64_t a, bn_u64_t b) {
+    #if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 bn_u128_t;
+        return (bn_u64_t)(((bn_u128_t)a * b) >> 64);
+    #else
+        const bn_u64_t aLo = a & 0xFFFFFFFF;
+        const bn_u64_t aHi = a >> 32;
+        const bn_u64_t bLo = b & 0xFFFFFFFF;
+        const bn_u64_t bHi = b >> 32;
+
+        const bn_u64_t mid = aHi * bLo + ((aLo * bLo) >> 32);
+        const bn_u64_t midLo = aLo * bHi + (mid & 0xFFFFFFFF);
+
+        return aHi * bHi + (mid >> 32) + (midLo >> 32);
+    #endif
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Division by a native integer
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+bn_u64_t abs_val_div_small(
+    container_t& num,
+    bn_u64_t divisor
 ) {
     typedef typename limits_t::base_single bn_single;
-    typedef typename limits_t::base_double bn_double;
-    
-    // numerical limits
-    static constexpr bn_double SINGLE_BASE_LIMIT = bn_max_limit<bn_single>() + (bn_double)1;
-    static constexpr bn_double SINGLE_BASE_MAX = bn_max_limit<bn_single>();
-    static constexpr bn_double SINGLE_BASE_MIN = bn_min_limit<bn_single>();
-    
-    const auto shift_left_1 = [](container_t& container)->void
-    {
-        if (container.empty())
-        {
-            return;
-        }
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
 
-        typename container_t::size_type curr = 0;
-        typename container_t::value_type carry = 0;
+    BN_ASSERT(divisor != 0 && divisor <= (bn_u64_t{1} << 32));
 
-        while (curr < container.size())
-        {
-            bn_single temp = (container[curr] * (bn_single)2) + carry;
-            container[curr] = temp;
-            carry = (bn_single)(temp > (bn_single)SINGLE_BASE_MAX ? 1 : 0);
-            container[curr] = temp % (bn_single)SINGLE_BASE_LIMIT;
-            ++curr;
-        }
+    // The remainder is always less than the divisor, so (rem*base + digit)
+    // cannot overflow 64 bits.
+    bn_u64_t rem = 0;
+
+    for (typename container_t::size_type i = num.size(); i --> 0;) {
+        const bn_u64_t cur = rem * NUM_BASE + (bn_u64_t)num[i];
+        num[i] = (bn_single)(cur / divisor);
+        rem = cur % divisor;
+    }
+
+    abs_val_trim<container_t>(num);
+
+    return rem;
+}
+
+
+
+template <class limits_t, class container_t>
+bn_u64_t abs_val_div_native(
+    container_t& num,
+    bn_u64_t divisor
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    if (divisor <= (bn_u64_t{1} << 32)) {
+        return abs_val_div_small<limits_t, container_t>(num, divisor);
+    }
+
+    container_t digits{};
+
+    while (divisor) {
+        digits.push_back((bn_single)(divisor % NUM_BASE));
+        divisor /= NUM_BASE;
+    }
+
+    container_t remainder{};
+    abs_val_divmod<limits_t, container_t>(num, digits, remainder);
+
+    // The remainder is less than the divisor, so it fits in 64 bits
+    bn_u64_t rem = 0;
+
+    for (typename container_t::size_type i = remainder.size(); i --> 0;) {
+        rem = rem * NUM_BASE + (bn_u64_t)remainder[i];
+    }
+
+    return rem;
+}
+
+
+
+template <class limits_t, class container_t>
+bn_u64_t abs_val_div_small_preinv(
+    container_t& num,
+    bn_u64_t divisor,
+    bn_u64_t inverse
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    BN_ASSERT(divisor != 0 && divisor <= (bn_u64_t{1} << 32));
+    BN_ASSERT(inverse == ~bn_u64_t{0} / divisor);
+
+    // The inverse is no more than 2^64/divisor, so each estimate never
+    // exceeds the quotient digit and falls short of it by at most two.
+    bn_u64_t rem = 0;
 
-        if (carry)
-        {
-            container.push_back((bn_single)SINGLE_BASE_MIN + (bn_single)1);
+    for (typename container_t::size_type i = num.size(); i --> 0;) {
+        const bn_u64_t cur = rem * NUM_BASE + (bn_u64_t)num[i];
+
+        bn_u64_t q = bn_mul_high(cur, inverse);
+        rem = cur - q * divisor;
+
+        while (rem >= divisor) {
+            ++q;
+            rem -= divisor;
         }
-    };
 
-    container_t res{{(bn_single)0}};
+        num[i] = (bn_single)q;
+    }
+
+    abs_val_trim<container_t>(num);
+
+    return rem;
+}
+
 
-    while (abs_val_is_ge<container_t>(dividend, divisor))
-    {
-        container_t bsrch0 = divisor;
-        container_t bsrch1 = divisor;
-        container_t q{{(bn_single)1}};
 
-        shift_left_1(bsrch1);
+///////////////////////////////////////////////////////////////////////////////
+// Greatest common divisor of native integers
+///////////////////////////////////////////////////////////////////////////////
+inline bn_u64_t bn_gcd(bn_u64_t a, bn_u64_t b) {
+    while (b) {
+        const bn_u64_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
 
-        while (abs_val_is_ge<container_t>(dividend, bsrch1))
-        {
-            bsrch0 = bsrch1;
 
-            shift_left_1(bsrch1);
-            shift_left_1(q);
+///////////////////////////////////////////////////////////////////////////////
+// Modular inverse of a native integer
+///////////////////////////////////////////////////////////////////////////////
+inline bn_u64_t bn_mod_inverse(bn_u64_t num, bn_u64_t modulus) {
+    // Extended Euclidean algorithm, keeping the coefficients of "num"
+    // reduced modulo the modulus so they never go negative.
+    bn_u64_t r0 = modulus;
+    bn_u64_t r1 = num % modulus;
+    bn_u64_t t0 = 0;
+    bn_u64_t t1 = 1;
+
+    while (r1) {
+        const bn_u64_t q = r0 / r1;
+        const bn_u64_t r2 = r0 - q * r1;
+        const bn_u64_t t2 = (t0 + modulus - (q % modulus) * t1 % modulus) % modulus;
+
+        r0 = r1;
+        r1 = r2;
+        t0 = t1;
+        t1 = t2;
+    }
+
+    BN_ASSERT(r0 == 1);
+
+    return t0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Exact division
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void divexact_kernel(
+    bn_iter_t<container_t> u, bn_size_t<container_t> qLen,
+    bn_citer_t<container_t> v, bn_size_t<container_t> vLen,
+    bn_u64_t vInverse
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    for (bn_size_t<container_t> i = 0; i < qLen; ++i) {
+        // The digit which cancels the lowest digit of the remainder
+        const bn_u64_t qDigit = ((bn_u64_t)u[i] * vInverse) % NUM_BASE;
+
+        if (!qDigit) {
+            continue;
         }
 
-        abs_val_sub<limits_t, container_t>(dividend, bsrch0);
+        // u[i..qLen) -= qDigit * v, dropping anything above the quotient
+        const bn_size_t<container_t> rowEnd = (vLen < qLen - i) ? i + vLen : qLen;
+
+        bn_u64_t carry = 0;
+        bn_u64_t borrow = 0;
+        bn_size_t<container_t> j = i;
+
+        for (; j < rowEnd; ++j) {
+            const bn_u64_t product = qDigit * (bn_u64_t)v[j-i] + carry;
+            const bn_u64_t sub = product % NUM_BASE + borrow;
+            const bn_u64_t digit = (bn_u64_t)u[j];
 
-        if (res.size() >= q.size())
-        {
-            abs_val_add<limits_t, container_t>(res, q);
+            carry = product / NUM_BASE;
+            borrow = digit < sub;
+            u[j] = (bn_single)(digit + (borrow ? NUM_BASE : 0) - sub);
         }
-        else
-        {
-            abs_val_add<limits_t, container_t>(q, res);
-            res = std::move(q);
+
+        for (carry += borrow; carry && j < qLen; ++j) {
+            const bn_u64_t sub = carry % NUM_BASE;
+            const bn_u64_t digit = (bn_u64_t)u[j];
+
+            carry /= NUM_BASE;
+
+            if (digit < sub) {
+                ++carry;
+                u[j] = (bn_single)(digit + NUM_BASE - sub);
+            }
+            else {
+                u[j] = (bn_single)(digit - sub);
+            }
         }
+
+        u[i] = (bn_single)qDigit;
+    }
+}
+
+
+
+template <typename limits_t, typename container_t>
+void divexact_split(
+    bn_iter_t<container_t> u, bn_size_t<container_t> qLen,
+    bn_citer_t<container_t> v, bn_size_t<container_t> vLen,
+    bn_u64_t vInverse
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    if (vLen > qLen) {
+        vLen = qLen;
+    }
+
+    if (qLen < BNThresholds<limits_t>::divExact || qLen < BN_EXACT_MIN_LEN || vLen < 2) {
+        divexact_kernel<limits_t, container_t>(u, qLen, v, vLen, vInverse);
+        return;
+    }
+
+    // The low half of the quotient only depends on the low half of each
+    // operand. Its product with the divisor then cancels the low half of
+    // the dividend, leaving the high half of the quotient to be found from
+    // what remains above it.
+    const bn_size_t<container_t> h = qLen / 2;
+
+    divexact_split<limits_t, container_t>(u, h, v, vLen, vInverse);
+
+    container_t qLow(u, u + h);
+    container_t vLow(v, v + (vLen < qLen ? vLen : qLen));
+
+    abs_val_trim<container_t>(qLow);
+    abs_val_trim<container_t>(vLow);
+
+    const container_t product = abs_val_mul<limits_t, container_t>(qLow, vLow);
+
+    // u[h..qLen) -= product[h..qLen)
+    const bn_size_t<container_t> pEnd = (product.size() < qLen) ? product.size() : qLen;
+    bn_u64_t borrow = 0;
+
+    for (bn_size_t<container_t> i = h; i < qLen && (borrow || i < pEnd); ++i) {
+        const bn_u64_t sub = ((i < pEnd) ? (bn_u64_t)product[i] : 0) + borrow;
+        const bn_u64_t digit = (bn_u64_t)u[i];
+
+        borrow = digit < sub;
+        u[i] = (bn_single)(digit + (borrow ? NUM_BASE : 0) - sub);
     }
 
-    dividend = std::move(res);
+    divexact_split<limits_t, container_t>(u + h, qLen - h, v, vLen, vInverse);
+}
+
+
+
+template <typename limits_t, typename container_t>
+void abs_val_divexact(
+    container_t& num,
+    const container_t& divisor
+) {
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
 
+    bn_size_t<container_t> vEnd = divisor.size();
+    bn_size_t<container_t> vBegin = 0;
+
+    while (vEnd && !divisor[vEnd-1]) {
+        --vEnd;
+    }
+
+    while (vBegin < vEnd && !divisor[vBegin]) {
+        ++vBegin;
+    }
+
+    BN_ASSERT(vBegin < vEnd);
+
+    abs_val_trim<container_t>(num);
+
+    #ifdef BN_DEBUG
+        const container_t dividend = num;
+    #endif
+
+    // Low zero digits of the divisor are matched by those of the dividend
+    num.erase(num.begin(), num.begin() + (vBegin < num.size() ? vBegin : num.size()));
+
+    container_t v{};
+    bn_citer_t<container_t> vIter = divisor.begin() + vBegin;
+    bn_size_t<container_t> vLen = vEnd - vBegin;
+    bn_u64_t common = bn_gcd((bn_u64_t)vIter[0], NUM_BASE);
+
+    // Any factor of the lowest digit which is shared with the base also
+    // divides the whole divisor, and therefore the dividend. Dividing both
+    // by it leaves a lowest digit with an inverse. Bases which are powers of
+    // 2 only need one pass.
+    if (common != 1) {
+        v.assign(vIter, vIter + vLen);
+
+        do {
+            abs_val_div_small<limits_t, container_t>(num, common);
+            abs_val_div_small<limits_t, container_t>(v, common);
+            common = bn_gcd((bn_u64_t)v[0], NUM_BASE);
+        } while (common != 1);
+
+        vIter = v.begin();
+        vLen = v.size();
+    }
+
+    if (num.size() < vLen) {
+        num.clear();
+    }
+    else {
+        const bn_size_t<container_t> qLen = num.size() - vLen + 1;
+
+        divexact_split<limits_t, container_t>(
+            num.begin(), qLen,
+            vIter, vLen,
+            bn_mod_inverse((bn_u64_t)vIter[0], NUM_BASE)
+        );
+
+        num.resize(qLen);
+        abs_val_trim<container_t>(num);
+    }
+
+    #ifdef BN_DEBUG
+    {
+        container_t check(divisor.begin(), divisor.begin() + vEnd);
+        check = abs_val_mul<limits_t, container_t>(num, check);
+        abs_val_trim<container_t>(check);
+        BN_ASSERT(abs_val_is_eq<container_t>(check, dividend));
+    }
+    #endif
 }
@@ -0,0 +1,170 @@
+/* 
+ * File:   bn_divisor_impl.h
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Construction
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+BignumDivisor<limits_t, container_t>::BignumDivisor(const bignum_type& num) :
+    divisor{num}
+{
+    prepare();
+}
+
+template <class limits_t, class container_t>
+BignumDivisor<limits_t, container_t>::BignumDivisor(bignum_type&& num) :
+    divisor{std::move(num)}
+{
+    prepare();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Divisor access
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline const typename BignumDivisor<limits_t, container_t>::bignum_type&
+BignumDivisor<limits_t, container_t>::getDivisor() const {
+    return divisor;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Precomputation
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+void BignumDivisor<limits_t, container_t>::prepare() {
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    if (!bignum_type::isComputable(divisor.descriptor)) {
+        return;
+    }
+
+    normalized = divisor.numData;
+    abs_val_trim<container_t>(normalized);
+
+    const bn_size_t<container_t> len = normalized.size();
+
+    // Zero is left to Bignum::divmod()
+    if (len == 0) {
+        normalized.clear();
+        return;
+    }
+
+    divisor.numData = normalized;
+
+    if (len == 1) {
+        inverse = ~bn_u64_t{0} / (bn_u64_t)normalized[0];
+        return;
+    }
+
+    // Same normalization as abs_val_divmod(). The inverse of the scale
+    // removes it from each remainder.
+    scale = NUM_BASE / ((bn_u64_t)normalized[len-1] + 1);
+    inverse = ~bn_u64_t{0} / scale;
+
+    abs_val_mul_small<limits_t, container_t>(normalized, scale);
+
+    if (len >= BNThresholds<limits_t>::divBarrett && len >= BN_NEWTON_MIN_LEN) {
+        reciprocal = div_newton_reciprocal<limits_t, container_t>(normalized.begin(), len);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Division
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+typename BignumDivisor<limits_t, container_t>::bignum_type
+BignumDivisor<limits_t, container_t>::divide(const bignum_type& num) const {
+    return divmod(num).first;
+}
+
+template <class limits_t, class container_t>
+typename BignumDivisor<limits_t, container_t>::bignum_type
+BignumDivisor<limits_t, container_t>::mod(const bignum_type& num) const {
+    return divmod(num).second;
+}
+
+template <class limits_t, class container_t>
+std::pair<
+    typename BignumDivisor<limits_t, container_t>::bignum_type,
+    typename BignumDivisor<limits_t, container_t>::bignum_type
+>
+BignumDivisor<limits_t, container_t>::divmod(const bignum_type& num) const {
+    typedef typename limits_t::base_single bn_single;
+
+    // Special values and division by zero follow the generic operators
+    if (!bignum_type::isComputable(num.descriptor)
+    || !bignum_type::isComputable(divisor.descriptor)
+    || normalized.empty()
+    ) {
+        return ::divmod(num, divisor);
+    }
+
+    std::pair<bignum_type, bignum_type> ret;
+    bignum_type& quotient = ret.first;
+    bignum_type& remainder = ret.second;
+
+    container_t u = num.numData;
+    abs_val_trim<container_t>(u);
+
+    const bn_size_t<container_t> vLen = normalized.size();
+
+    if (vLen == 1) {
+        const bn_u64_t rem = abs_val_div_small_preinv<limits_t, container_t>(u, (bn_u64_t)normalized[0], inverse);
+
+        quotient.numData = std::move(u);
+
+        if (rem) {
+            remainder.numData.push_back((bn_single)rem);
+        }
+    }
+    else if (!abs_val_is_ge<container_t>(u, divisor.numData)) {
+        remainder.numData = std::move(u);
+    }
+    else {
+        if (scale != 1) {
+            abs_val_mul_small<limits_t, container_t>(u, scale);
+        }
+
+        const bn_size_t<container_t> uLen = u.size();
+
+        const std::size_t burnikelLen = (BNThresholds<limits_t>::divBurnikel > BN_BURNIKEL_MIN_LEN)
+            ? BNThresholds<limits_t>::divBurnikel
+            : BN_BURNIKEL_MIN_LEN;
+
+        // The reciprocal costs two multiplications for each block of
+        // quotient digits, which only pays off for long quotients.
+        if (!reciprocal.empty() && uLen - vLen >= BNThresholds<limits_t>::divBarrett) {
+            quotient.numData = div_reciprocal<limits_t, container_t>(u, normalized, reciprocal);
+        }
+        else if (vLen >= burnikelLen && uLen - vLen >= burnikelLen) {
+            quotient.numData = div_burnikel<limits_t, container_t>(u, normalized);
+        }
+        else {
+            quotient.numData = div_knuth<limits_t, container_t>(u, normalized);
+        }
+
+        if (scale != 1) {
+            abs_val_div_small_preinv<limits_t, container_t>(u, scale, inverse);
+        }
+
+        remainder.numData = std::move(u);
+    }
+
+    // Signs match those of Bignum::divmod()
+    if (quotient.numData.empty()) {
+        quotient.numData = {bn_single{0}};
+    }
+    else {
+        quotient.descriptor = (num.descriptor == divisor.descriptor) ? BN_POS : BN_NEG;
+    }
+
+    if (remainder.numData.empty()) {
+        remainder.numData = {bn_single{0}};
+    }
+    else {
+        remainder.descriptor = num.descriptor;
+    }
+
+    return ret;
+}
@@ -80,3 +80,12 @@ template <>
 constexpr bn_u64_t bn_min_limit<bn_base16_double>() {return 0;}
 template <>
 constexpr bn_u64_t bn_max_limit<bn_base16_double>() {return 255;}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Bit counting
+///////////////////////////////////////////////////////////////////////////////
+constexpr bn_u64_t bn_bit_width(bn_u64_t n) {
+    return n ? (1 + bn_bit_width(n >> 1)) : 0;
+}
@@ -5,95 +5,1487 @@
  * Created on January 15, 2016, 10:02 AM
  */
 
+#include "bignum/bn_division.h"
 #include "bignum/fourier.h"
+#include "bignum/ntt.h"
 
 
 
 ///////////////////////////////////////////////////////////////////////////////
 // FFT-based multiplication
 ///////////////////////////////////////////////////////////////////////////////
-template <typename limits_t, typename container_t>
+/*
+ * Round the coefficients of an inverse transform to integers and propagate
+ * their carries into a container of digits. Digits which were split into
+ * numPieces fields of pieceBits bits are reassembled along the way.
+ * 
+ * Large products are normalized in parallel chunks of digits, each starting
+ * with no carry. The carry out of every chunk is then added to the start of
+ * the next one, which only touches a few digits past each boundary.
+ */
+template <typename limits_t, typename container_t, typename coeff_func_t>
+container_t fft_round_carry(
+    bn_u64_t numCoeffs,
+    coeff_func_t&& coeff,
+    unsigned numPieces,
+    unsigned pieceBits
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    // The double-precision type of some limits is no larger than a single
+    // digit, so carries are accumulated in the widest available integer.
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX+1};
+
+    const bn_u64_t numDigits = (numCoeffs + numPieces - 1) / numPieces;
+    const std::size_t numTasks = fft_num_tasks(numCoeffs);
+    const std::size_t chunkLen = fft_chunk_length(numTasks, numDigits, 1);
+
+    container_t ret;
+
+    if (!numDigits) {
+        return ret;
+    }
+
+    ret.resize(numDigits);
+    const bn_iter_t<container_t> out = ret.begin();
+
+    // carry out of the most-significant digit of each chunk
+    std::vector<bn_u64_t> carries;
+    carries.resize((numDigits + chunkLen - 1) / chunkLen);
+
+    fft_parallel_chunks(numTasks, numDigits, 1, [&](bn_u64_t first, bn_u64_t last) {
+        // Local copies can stay in registers, where captured references
+        // might alias the output digits.
+        const unsigned chunkPieces = numPieces;
+        const unsigned chunkPieceBits = pieceBits;
+        const bn_iter_t<container_t> chunkOut = out;
+
+        const bn_u64_t lastCoeff = (last * chunkPieces < numCoeffs) ? last * chunkPieces : numCoeffs;
+        bn_u64_t c = 0;
+
+        if (chunkPieces == 1) {
+            for (bn_u64_t i = first; i < lastCoeff; ++i) {
+                // round to an integer
+                const bn_u64_t ci = c + (bn_u64_t)std::floor(coeff(i) + 0.5);
+
+                chunkOut[i] = (bn_single)(ci % NUM_BASE);
+
+                // carry propagation
+                c = (ci / NUM_BASE);
+            }
+        }
+        else {
+            const bn_u64_t pieceMask = (bn_u64_t{1} << chunkPieceBits) - 1;
+            bn_u64_t digit = 0;
+            bn_u64_t d = first;
+            unsigned piece = 0;
+
+            for (bn_u64_t i = first * chunkPieces; i < lastCoeff; ++i) {
+                const bn_u64_t ci = c + (bn_u64_t)std::floor(coeff(i) + 0.5);
+
+                digit |= (ci & pieceMask) << (piece * chunkPieceBits);
+                c = ci >> chunkPieceBits;
+
+                if (++piece == chunkPieces) {
+                    chunkOut[d++] = (bn_single)digit;
+                    digit = 0;
+                    piece = 0;
+                }
+            }
+
+            if (piece) {
+                chunkOut[d] = (bn_single)digit;
+            }
+        }
+
+        carries[first / chunkLen] = c;
+    });
+
+    // Carries rarely ripple more than a digit or two into the next chunk.
+    for (bn_u64_t t = 1; t < carries.size(); ++t) {
+        bn_u64_t c = carries[t-1];
+
+        for (bn_u64_t i = t * chunkLen; c && i < numDigits; ++i) {
+            const bn_u64_t ci = c + (bn_u64_t)out[i];
+            out[i] = (bn_single)(ci % NUM_BASE);
+            c = ci / NUM_BASE;
+        }
+    }
+
+    // trim trailing zeroes from the most-significant digits
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
+
+
+
+/*
+ * Number of bit fields each digit is split into for an FFT product. Products
+ * which cannot be made exact keep their digits whole.
+ */
+template <typename limits_t, typename flt_t>
+inline unsigned fft_split_count(bn_u64_t aLen, bn_u64_t bLen) {
+    const unsigned numPieces = fft_num_pieces<flt_t>(limits_t::SINGLE_BASE_MAX, aLen, bLen);
+    return numPieces ? numPieces : 1;
+}
+
+
+
+template <typename limits_t, typename container_t, typename flt_t>
 container_t mul_strassen(const container_t& a, const container_t& b) {
-    // Default type is double. Use floats if they perform well enough.
-    typedef double flt_t;
-    typedef typename limits_t::base_double bn_double;
-    typedef typename container_t::size_type big_size_type;
-    static constexpr bn_double NUM_BASE = bn_double{limits_t::SINGLE_BASE_MAX+1};
+    const unsigned numPieces = fft_split_count<limits_t, flt_t>(a.size(), b.size());
+    const unsigned pieceBits = (unsigned)bn_bit_width(limits_t::SINGLE_BASE_MAX) / numPieces;
     
 	// building a complex signal with the information of both signals.
-    cmplx_list_t<flt_t> fftTable = std::move(create_fft_table<container_t, flt_t>(a, b));
+    cmplx_list_t<flt_t> fftTable = create_fft_table<container_t, flt_t>(a, b, numPieces, pieceBits);
     
     convolute_fft<flt_t>(fftTable);
     ifft_complex<flt_t>(fftTable);
     
-    const cmplx_list_t<flt_t>& inverses = fftTable;
-    
-    container_t ret;
-    ret.reserve(inverses.size());
+    // drop imaginary part of the number
+    return fft_round_carry<limits_t, container_t>(
+        fftTable.size(),
+        [&fftTable](bn_u64_t i)->flt_t { return fftTable.re[i]; },
+        numPieces,
+        pieceBits
+    );
+}
+
+
+
+template <typename limits_t, typename container_t, typename flt_t>
+container_t sqr_strassen(const container_t& a) {
+    const unsigned numPieces = fft_split_count<limits_t, flt_t>(a.size(), a.size());
+    const unsigned pieceBits = (unsigned)bn_bit_width(limits_t::SINGLE_BASE_MAX) / numPieces;
+
+    cmplx_list_t<flt_t> fftTable = create_fft_sqr_table<container_t, flt_t>(a, numPieces, pieceBits);
+
+    convolute_fft_sqr<flt_t>(fftTable);
+    ifft_complex<flt_t>(fftTable);
+
+    // even coefficients are held in the real parts, odd ones in the
+    // imaginary parts
+    return fft_round_carry<limits_t, container_t>(
+        fftTable.size() * 2,
+        [&fftTable](bn_u64_t i)->flt_t { return (i & 1) ? fftTable.im[i/2] : fftTable.re[i/2]; },
+        numPieces,
+        pieceBits
+    );
+}
+
+
+
+template <typename limits_t, typename container_t, typename flt_t>
+container_t mul_strassen_spectrum(
+    const container_t& a,
+    const BNRealSpectrum<flt_t>& b,
+    unsigned numPieces
+) {
+    const unsigned pieceBits = (unsigned)bn_bit_width(limits_t::SINGLE_BASE_MAX) / numPieces;
+
+    cmplx_list_t<flt_t> fftTable = create_fft_real_table<container_t, flt_t>(a, b.fftSize, numPieces, pieceBits);
+
+    convolute_fft_spectrum<flt_t>(fftTable, b);
+    ifft_complex<flt_t>(fftTable);
+
+    return fft_round_carry<limits_t, container_t>(
+        fftTable.size() * 2,
+        [&fftTable](bn_u64_t i)->flt_t { return (i & 1) ? fftTable.im[i/2] : fftTable.re[i/2]; },
+        numPieces,
+        pieceBits
+    );
+}
 
-    for (cmplx_size_t<flt_t> i = 0, c = 0; i < inverses.size(); ++i) {
-        // drop imaginary part of the number
-        const flt_t x = inverses[i].real();
-        
-        // round to an integer
-        const bn_double ci = (bn_double)(c + std::floor(x + 0.5));
-        
-        ret.push_back(ci % NUM_BASE);
 
-        // carry propagation
-        c = (ci / NUM_BASE);
+
+template <typename limits_t, typename container_t, typename flt_t>
+container_t mul_strassen_unbalanced(const container_t& a, const container_t& b) {
+    const bn_size_t<container_t> aLen = a.size();
+    const bn_size_t<container_t> bLen = b.size();
+
+    BN_ASSERT(aLen >= bLen);
+
+    if (!bLen) {
+        return container_t{};
     }
-    
-    // trim trailing zeroes from the most-significant digits
-    big_size_type numZeroes = 0;
-    
-    for (big_size_type i = ret.size(); i --> 0;) {
-        if (ret[i]) {
-            break;
+
+    // Rounding errors only shrink with the transform length, so fields which
+    // are exact for the whole product are also exact for each chunk.
+    const unsigned numPieces = fft_split_count<limits_t, flt_t>(aLen, bLen);
+    const unsigned pieceBits = (unsigned)bn_bit_width(limits_t::SINGLE_BASE_MAX) / numPieces;
+
+    const cmplx_size_t<flt_t> fftSize = fft_real_length<flt_t>(2 * bLen * numPieces);
+
+    cmplx_list_t<flt_t> fftTable = create_fft_real_table<container_t, flt_t>(b, fftSize, numPieces, pieceBits);
+    const BNRealSpectrum<flt_t> spectrum = fft_real_spectrum<flt_t>(fftTable);
+
+    return mul_strassen_spectrum_unbalanced<limits_t, container_t, flt_t>(a, bLen, spectrum, numPieces);
+}
+
+
+
+template <typename limits_t, typename container_t, typename flt_t>
+container_t mul_strassen_spectrum_unbalanced(
+    const container_t& a,
+    bn_size_t<container_t> bLen,
+    const BNRealSpectrum<flt_t>& b,
+    unsigned numPieces
+) {
+    const bn_size_t<container_t> aLen = a.size();
+
+    // Each chunk fills whatever room the transform has left after the
+    // shorter operand.
+    const bn_size_t<container_t> chunkLen = 2 * b.fftSize / numPieces - bLen;
+
+    BN_ASSERT(chunkLen >= bLen);
+
+    container_t ret{};
+
+    for (bn_size_t<container_t> first = 0; first < aLen; first += chunkLen) {
+        const bn_size_t<container_t> last = (aLen - first < chunkLen) ? aLen : first + chunkLen;
+
+        container_t chunk{a.begin()+first, a.begin()+last};
+        abs_val_trim<container_t>(chunk);
+
+        if (!chunk.empty()) {
+            abs_val_add_shifted<limits_t, container_t>(ret, mul_strassen_spectrum<limits_t, container_t, flt_t>(chunk, b, numPieces), first);
         }
-        
-        ++numZeroes;
     }
-    
-    ret.resize(ret.size() - numZeroes);
+
+    abs_val_trim<container_t>(ret);
 
     return ret;
 }
 
 
 
+///////////////////////////////////////////////////////////////////////////////
+// NTT-based multiplication
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t mul_ntt(const container_t& a, const container_t& b) {
+    return mul_ntt_split<limits_t, container_t>(a, b, ntt_max_length(1));
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t mul_ntt_split(const container_t& a, const container_t& b, ntt_size_t maxLen) {
+    typedef typename container_t::size_type big_size_type;
+
+    const big_size_type aLen = a.size();
+    const big_size_type bLen = b.size();
+
+    if (!aLen || !bLen) {
+        return container_t{};
+    }
+
+    const unsigned numPrimes = ntt_num_primes(limits_t::SINGLE_BASE_MAX, aLen < bLen ? aLen : bLen);
+    const ntt_size_t len = ntt_length(aLen, bLen);
+
+    // Operands which are too large for a single transform are multiplied in
+    // halves, then recombined.
+    if (!numPrimes || len > ntt_max_length(numPrimes) || len > maxLen) {
+        const container_t& longer = (aLen >= bLen) ? a : b;
+        const container_t& shorter = (aLen >= bLen) ? b : a;
+        const big_size_type half = longer.size() / 2;
+
+        const container_t lo{longer.begin(), longer.begin()+half};
+        const container_t hi{longer.begin()+half, longer.end()};
+
+        container_t ret = mul_ntt_split<limits_t, container_t>(lo, shorter, maxLen);
+        abs_val_add_shifted<limits_t, container_t>(ret, mul_ntt_split<limits_t, container_t>(hi, shorter, maxLen), half);
+
+        return ret;
+    }
+
+    ntt_list_t residues[BN_NTT_NUM_PRIMES];
+
+    for (unsigned p = 0; p < numPrimes; ++p) {
+        ntt_list_t& ra = residues[p];
+
+        ra = create_ntt_table<container_t>(a, len, p);
+        ntt_forward(ra, p);
+
+        if (&a == &b) {
+            ntt_pointwise(ra, ra, p);
+        }
+        else {
+            ntt_list_t rb = create_ntt_table<container_t>(b, len, p);
+            ntt_forward(rb, p);
+            ntt_pointwise(ra, rb, p);
+        }
+
+        ntt_inverse(ra, p);
+    }
+
+    return ntt_crt_carry<limits_t, container_t>(residues, numPrimes, aLen + bLen - 1);
+}
+
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Naive Multiplication
 ///////////////////////////////////////////////////////////////////////////////
 template <typename limits_t, typename container_t>
 container_t mul_naive(const container_t& a, const container_t& b) {
-    typedef typename limits_t::base_double bn_double;
-    typedef typename container_t::size_type big_size_type;
-    static constexpr bn_double NUM_BASE = (bn_double)limits_t::SINGLE_BASE_MAX+(bn_double)1;
-    
+    typedef typename limits_t::base_single bn_single;
+
     container_t ret{};
-    
-    const big_size_type totalLen = a.size() + b.size();
-    
-    if (!totalLen) {
+
+    if (a.empty() || b.empty()) {
         return ret;
     }
-    
-    ret.resize(totalLen);
-    
-    for (unsigned i = 0; i < b.size(); ++i) {
-        unsigned remainder = 0;
-        
-        for (unsigned j = 0; j < a.size(); ++j) {
-            const big_size_type index = i + j;
-            ret[index] += remainder + a[j] * b[i];
-            remainder = ret[index] / NUM_BASE;
-            ret[index] = ret[index] % NUM_BASE;
-        }
-        
-        ret[i+a.size()] += remainder;
+
+    ret.resize(a.size() + b.size(), bn_single{0});
+    mul_schoolbook_kernel<limits_t, container_t>(a.begin(), a.size(), b.begin(), b.size(), ret.begin());
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t sqr_naive(const container_t& a) {
+    typedef typename limits_t::base_single bn_single;
+
+    container_t ret{};
+
+    if (a.empty()) {
+        return ret;
     }
-    
+
+    ret.resize(a.size() * 2, bn_single{0});
+    sqr_schoolbook_kernel<limits_t, container_t>(a.begin(), a.size(), ret.begin());
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Karatsuba Multiplication
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t mul_karatsuba(const container_t& a, const container_t& b) {
+    typedef typename limits_t::base_single bn_single;
+
+    container_t ret{};
+
+    if (a.empty() || b.empty()) {
+        return ret;
+    }
+
+    const bn_size_t<container_t> maxLen = a.size() > b.size() ? a.size() : b.size();
+    container_t scratch(mul_karatsuba_scratch<container_t>(maxLen), bn_single{0});
+
+    ret.resize(a.size() + b.size(), bn_single{0});
+    mul_karatsuba_kernel<limits_t, container_t>(a.begin(), a.size(), b.begin(), b.size(), ret.begin(), scratch.begin());
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t sqr_karatsuba(const container_t& a) {
+    typedef typename limits_t::base_single bn_single;
+
+    container_t ret{};
+
+    if (a.empty()) {
+        return ret;
+    }
+
+    container_t scratch(mul_karatsuba_scratch<container_t>(a.size()), bn_single{0});
+
+    ret.resize(a.size() * 2, bn_single{0});
+    sqr_karatsuba_kernel<limits_t, container_t>(a.begin(), a.size(), ret.begin(), scratch.begin());
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Toom-Cook Multiplication
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Multiply each part of a long operand by a short operand, which is no
+ * longer than a single part.
+ */
+template <typename limits_t, typename container_t>
+container_t mul_toom_unbalanced(
+    const container_t& longer,
+    const container_t& shorter,
+    unsigned numParts,
+    bn_size_t<container_t> k
+) {
+    container_t ret{};
+
+    for (unsigned i = 0; i < numParts && i*k < longer.size(); ++i) {
+        const bn_size_t<container_t> last = (i+1)*k < longer.size() ? (i+1)*k : longer.size();
+        container_t part{longer.begin()+i*k, longer.begin()+last};
+
+        abs_val_trim<container_t>(part);
+        abs_val_add_shifted<limits_t, container_t>(ret, abs_val_mul<limits_t, container_t>(part, shorter), i*k);
+    }
+
+    abs_val_trim<container_t>(ret);
+
     return ret;
 }
 
+
+
+/*
+ * Split a number into "numParts" signed values of "k" digits each.
+ */
+template <typename container_t>
+void toom_split(
+    const container_t& num,
+    BNToomValue<container_t>* parts,
+    unsigned numParts,
+    bn_size_t<container_t> k
+) {
+    for (unsigned i = 0; i < numParts; ++i) {
+        const bn_size_t<container_t> first = i*k < num.size() ? i*k : num.size();
+        const bn_size_t<container_t> last = first+k < num.size() ? first+k : num.size();
+
+        parts[i].negative = false;
+        parts[i].digits.assign(num.begin()+first, num.begin()+last);
+        abs_val_trim<container_t>(parts[i].digits);
+    }
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t mul_toom3(const container_t& a, const container_t& b) {
+    typedef BNToomValue<container_t> toom_t;
+
+    const bn_size_t<container_t> aLen = a.size();
+    const bn_size_t<container_t> bLen = b.size();
+
+    if (!aLen || !bLen) {
+        return container_t{};
+    }
+
+    if (aLen < BN_TOOM_MIN_LEN || bLen < BN_TOOM_MIN_LEN) {
+        return (&a == &b)
+            ? sqr_karatsuba<limits_t, container_t>(a)
+            : mul_karatsuba<limits_t, container_t>(a, b);
+    }
+
+    const bn_size_t<container_t> k = ((aLen > bLen ? aLen : bLen) + 2) / 3;
+
+    if (aLen <= k) {
+        return mul_toom_unbalanced<limits_t, container_t>(b, a, 3, k);
+    }
+
+    if (bLen <= k) {
+        return mul_toom_unbalanced<limits_t, container_t>(a, b, 3, k);
+    }
+
+    // Evaluate x0 + x1*t + x2*t^2 at t = {0, 1, -1, -2, inf}
+    const auto evaluate = [](const toom_t* x, toom_t* p)->void {
+        toom_t evens = x[0];
+        toom_add<limits_t, container_t>(evens, x[2]);
+
+        p[0] = x[0];
+
+        p[1] = evens;
+        toom_add<limits_t, container_t>(p[1], x[1]);
+
+        p[2] = std::move(evens);
+        toom_sub<limits_t, container_t>(p[2], x[1]);
+
+        // p(-2) = 2*(p(-1) + x2) - x0
+        p[3] = p[2];
+        toom_add<limits_t, container_t>(p[3], x[2]);
+        toom_mul_small<limits_t, container_t>(p[3], 2);
+        toom_sub<limits_t, container_t>(p[3], x[0]);
+
+        p[4] = x[2];
+    };
+
+    toom_t parts[3];
+    toom_t pa[5];
+    toom_t pb[5];
+    toom_t r[5];
+
+    toom_split<container_t>(a, parts, 3, k);
+    evaluate(parts, pa);
+
+    // Squares only need one evaluation, and each pointwise product is then
+    // a square as well.
+    if (&a != &b) {
+        toom_split<container_t>(b, parts, 3, k);
+        evaluate(parts, pb);
+    }
+
+    const toom_t* const rhs = (&a != &b) ? pb : pa;
+
+    for (unsigned i = 0; i < 5; ++i) {
+        r[i] = toom_mul<limits_t, container_t>(pa[i], rhs[i]);
+    }
+
+    // Bodrato's interpolation sequence
+    // r3 = (r(-2) - r(1)) / 3
+    toom_t r3 = std::move(r[3]);
+    toom_sub<limits_t, container_t>(r3, r[1]);
+    toom_div_exact<limits_t, container_t>(r3, 3);
+
+    // r1 = (r(1) - r(-1)) / 2
+    toom_t r1 = std::move(r[1]);
+    toom_sub<limits_t, container_t>(r1, r[2]);
+    toom_div_exact<limits_t, container_t>(r1, 2);
+
+    // r2 = r(-1) - r(0)
+    toom_t r2 = std::move(r[2]);
+    toom_sub<limits_t, container_t>(r2, r[0]);
+
+    // r3 = (r2 - r3)/2 + 2*r(inf)
+    toom_t temp = r2;
+    toom_sub<limits_t, container_t>(temp, r3);
+    toom_div_exact<limits_t, container_t>(temp, 2);
+    r3 = r[4];
+    toom_mul_small<limits_t, container_t>(r3, 2);
+    toom_add<limits_t, container_t>(r3, temp);
+
+    // r2 = r2 + r1 - r(inf)
+    toom_add<limits_t, container_t>(r2, r1);
+    toom_sub<limits_t, container_t>(r2, r[4]);
+
+    // r1 = r1 - r3
+    toom_sub<limits_t, container_t>(r1, r3);
+
+    r[1] = std::move(r1);
+    r[2] = std::move(r2);
+    r[3] = std::move(r3);
+
+    return toom_recompose<limits_t, container_t>(r, 5, k);
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t mul_toom4(const container_t& a, const container_t& b) {
+    typedef BNToomValue<container_t> toom_t;
+
+    const bn_size_t<container_t> aLen = a.size();
+    const bn_size_t<container_t> bLen = b.size();
+
+    if (!aLen || !bLen) {
+        return container_t{};
+    }
+
+    if (aLen < BN_TOOM_MIN_LEN || bLen < BN_TOOM_MIN_LEN) {
+        return (&a == &b)
+            ? sqr_karatsuba<limits_t, container_t>(a)
+            : mul_karatsuba<limits_t, container_t>(a, b);
+    }
+
+    const bn_size_t<container_t> k = ((aLen > bLen ? aLen : bLen) + 3) / 4;
+
+    if (aLen <= k) {
+        return mul_toom_unbalanced<limits_t, container_t>(b, a, 4, k);
+    }
+
+    if (bLen <= k) {
+        return mul_toom_unbalanced<limits_t, container_t>(a, b, 4, k);
+    }
+
+    // Evaluate x0 + x1*t + x2*t^2 + x3*t^3 at t = {0, 1, -1, 2, -2, 3, inf}
+    const auto evaluate = [](const toom_t* x, toom_t* p)->void {
+        // x0 + x2, x1 + x3
+        toom_t evens = x[0];
+        toom_t odds = x[1];
+        toom_add<limits_t, container_t>(evens, x[2]);
+        toom_add<limits_t, container_t>(odds, x[3]);
+
+        p[0] = x[0];
+
+        p[1] = evens;
+        toom_add<limits_t, container_t>(p[1], odds);
+
+        p[2] = std::move(evens);
+        toom_sub<limits_t, container_t>(p[2], odds);
+
+        // x0 + 4*x2, 2*(x1 + 4*x3)
+        evens = x[2];
+        toom_mul_small<limits_t, container_t>(evens, 4);
+        toom_add<limits_t, container_t>(evens, x[0]);
+
+        odds = x[3];
+        toom_mul_small<limits_t, container_t>(odds, 4);
+        toom_add<limits_t, container_t>(odds, x[1]);
+        toom_mul_small<limits_t, container_t>(odds, 2);
+
+        p[3] = evens;
+        toom_add<limits_t, container_t>(p[3], odds);
+
+        p[4] = std::move(evens);
+        toom_sub<limits_t, container_t>(p[4], odds);
+
+        // Horner's rule for p(3)
+        p[5] = x[3];
+
+        for (unsigned i = 3; i --> 0;) {
+            toom_mul_small<limits_t, container_t>(p[5], 3);
+            toom_add<limits_t, container_t>(p[5], x[i]);
+        }
+
+        p[6] = x[3];
+    };
+
+    toom_t parts[4];
+    toom_t pa[7];
+    toom_t pb[7];
+    toom_t r[7];
+
+    toom_split<container_t>(a, parts, 4, k);
+    evaluate(parts, pa);
+
+    // Squares only need one evaluation, and each pointwise product is then
+    // a square as well.
+    if (&a != &b) {
+        toom_split<container_t>(b, parts, 4, k);
+        evaluate(parts, pb);
+    }
+
+    const toom_t* const rhs = (&a != &b) ? pb : pa;
+
+    for (unsigned i = 0; i < 7; ++i) {
+        r[i] = toom_mul<limits_t, container_t>(pa[i], rhs[i]);
+    }
+
+    // Remove the known coefficients, c0 and c6, from the remaining points
+    // so that v(t) = c1*t + c2*t^2 + c3*t^3 + c4*t^4 + c5*t^5.
+    toom_t temp = r[6];
+    toom_mul_small<limits_t, container_t>(temp, 64);
+    toom_add<limits_t, container_t>(temp, r[0]);
+    toom_sub<limits_t, container_t>(r[3], temp);
+    toom_sub<limits_t, container_t>(r[4], temp);
+
+    temp = r[6];
+    toom_mul_small<limits_t, container_t>(temp, 729);
+    toom_add<limits_t, container_t>(temp, r[0]);
+    toom_sub<limits_t, container_t>(r[5], temp);
+
+    temp = r[6];
+    toom_add<limits_t, container_t>(temp, r[0]);
+    toom_sub<limits_t, container_t>(r[1], temp);
+    toom_sub<limits_t, container_t>(r[2], temp);
+
+    // e1 = c2 + c4, o1 = c1 + c3 + c5
+    toom_t e1 = r[1];
+    toom_add<limits_t, container_t>(e1, r[2]);
+    toom_div_exact<limits_t, container_t>(e1, 2);
+
+    toom_t o1 = std::move(r[1]);
+    toom_sub<limits_t, container_t>(o1, r[2]);
+    toom_div_exact<limits_t, container_t>(o1, 2);
+
+    // e2 = c2 + 4*c4, o2 = c1 + 4*c3 + 16*c5
+    toom_t e2 = r[3];
+    toom_add<limits_t, container_t>(e2, r[4]);
+    toom_div_exact<limits_t, container_t>(e2, 8);
+
+    toom_t o2 = std::move(r[3]);
+    toom_sub<limits_t, container_t>(o2, r[4]);
+    toom_div_exact<limits_t, container_t>(o2, 4);
+
+    // c4 = (e2 - e1) / 3, c2 = e1 - c4
+    toom_t c4 = std::move(e2);
+    toom_sub<limits_t, container_t>(c4, e1);
+    toom_div_exact<limits_t, container_t>(c4, 3);
+
+    toom_t c2 = std::move(e1);
+    toom_sub<limits_t, container_t>(c2, c4);
+
+    // w = (v(3) - 9*c2 - 81*c4) / 3 = c1 + 9*c3 + 81*c5
+    toom_t w = std::move(r[5]);
+    temp = c2;
+    toom_mul_small<limits_t, container_t>(temp, 9);
+    toom_sub<limits_t, container_t>(w, temp);
+    temp = c4;
+    toom_mul_small<limits_t, container_t>(temp, 81);
+    toom_sub<limits_t, container_t>(w, temp);
+    toom_div_exact<limits_t, container_t>(w, 3);
+
+    // d1 = (o2 - o1) / 3 = c3 + 5*c5, d2 = (w - o2) / 5 = c3 + 13*c5
+    toom_t d1 = o2;
+    toom_sub<limits_t, container_t>(d1, o1);
+    toom_div_exact<limits_t, container_t>(d1, 3);
+
+    toom_t d2 = std::move(w);
+    toom_sub<limits_t, container_t>(d2, o2);
+    toom_div_exact<limits_t, container_t>(d2, 5);
+
+    // c5 = (d2 - d1) / 8, c3 = d1 - 5*c5, c1 = o1 - c3 - c5
+    toom_t c5 = std::move(d2);
+    toom_sub<limits_t, container_t>(c5, d1);
+    toom_div_exact<limits_t, container_t>(c5, 8);
+
+    temp = c5;
+    toom_mul_small<limits_t, container_t>(temp, 5);
+    toom_t c3 = std::move(d1);
+    toom_sub<limits_t, container_t>(c3, temp);
+
+    toom_t c1 = std::move(o1);
+    toom_sub<limits_t, container_t>(c1, c3);
+    toom_sub<limits_t, container_t>(c1, c5);
+
+    r[1] = std::move(c1);
+    r[2] = std::move(c2);
+    r[3] = std::move(c3);
+    r[4] = std::move(c4);
+    r[5] = std::move(c5);
+
+    return toom_recompose<limits_t, container_t>(r, 7, k);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiplication Dispatch
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t abs_val_mul(const container_t& a, const container_t& b) {
+    if (&a == &b) {
+        return abs_val_sqr<limits_t, container_t>(a);
+    }
+
+    const bn_size_t<container_t> minLen = a.size() < b.size() ? a.size() : b.size();
+
+    if (!minLen) {
+        return container_t{};
+    }
+
+    // The transform thresholds of wide digits may be lower than those of the
+    // Toom-Cook methods, so they are checked first.
+    if (minLen < BNThresholds<limits_t>::mulFFT) {
+        if (minLen < BNThresholds<limits_t>::mulKaratsuba) {
+            return mul_naive<limits_t, container_t>(a, b);
+        }
+
+        if (minLen < BNThresholds<limits_t>::mulToom3) {
+            return mul_karatsuba<limits_t, container_t>(a, b);
+        }
+
+        if (minLen < BNThresholds<limits_t>::mulToom4) {
+            return mul_toom3<limits_t, container_t>(a, b);
+        }
+
+        return mul_toom4<limits_t, container_t>(a, b);
+    }
+
+    // A longer operand of at least 4 chunks is split up, each chunk being
+    // multiplied against a single transform of the shorter operand.
+    const container_t& longer = (a.size() >= b.size()) ? a : b;
+    const container_t& shorter = (a.size() >= b.size()) ? b : a;
+    const bool unbalanced = minLen >= BNThresholds<limits_t>::mulUnbalanced && longer.size() >= 4 * minLen;
+
+    // Use the floating-point FFT while its rounding is exact, starting with
+    // the narrowest type suited to limits_t. Wide digits are split into
+    // smaller bit fields for a double-precision transform before falling back
+    // to the integer transform.
+    if (fft_is_exact<fft_float_t<limits_t>>(limits_t::SINGLE_BASE_MAX, a.size(), b.size())) {
+        return unbalanced
+            ? mul_strassen_unbalanced<limits_t, container_t, fft_float_t<limits_t>>(longer, shorter)
+            : mul_strassen<limits_t, container_t, fft_float_t<limits_t>>(a, b);
+    }
+
+    if (fft_num_pieces<double>(limits_t::SINGLE_BASE_MAX, a.size(), b.size())) {
+        return unbalanced
+            ? mul_strassen_unbalanced<limits_t, container_t, double>(longer, shorter)
+            : mul_strassen<limits_t, container_t, double>(a, b);
+    }
+
+    return mul_ntt<limits_t, container_t>(a, b);
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t abs_val_sqr(const container_t& a) {
+    const bn_size_t<container_t> len = a.size();
+
+    if (!len) {
+        return container_t{};
+    }
+
+    if (len < BNThresholds<limits_t>::mulFFT) {
+        if (len < BNThresholds<limits_t>::sqrKaratsuba) {
+            return sqr_naive<limits_t, container_t>(a);
+        }
+
+        if (len < BNThresholds<limits_t>::mulToom3) {
+            return sqr_karatsuba<limits_t, container_t>(a);
+        }
+
+        // The Toom-Cook and NTT routines detect aliased operands themselves.
+        if (len < BNThresholds<limits_t>::mulToom4) {
+            return mul_toom3<limits_t, container_t>(a, a);
+        }
+
+        return mul_toom4<limits_t, container_t>(a, a);
+    }
+
+    if (fft_is_exact<fft_float_t<limits_t>>(limits_t::SINGLE_BASE_MAX, len, len)) {
+        return sqr_strassen<limits_t, container_t, fft_float_t<limits_t>>(a);
+    }
+
+    if (fft_num_pieces<double>(limits_t::SINGLE_BASE_MAX, len, len)) {
+        return sqr_strassen<limits_t, container_t, double>(a);
+    }
+
+    return mul_ntt<limits_t, container_t>(a, a);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiplication by a native integer
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void abs_val_mul_small(container_t& num, bn_u64_t factor) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    BN_ASSERT(factor <= (bn_u64_t{1} << 32));
+
+    if (!factor) {
+        num.clear();
+        return;
+    }
+
+    // digit*factor + carry < base*factor, which always fits within 64 bits
+    bn_u64_t carry = 0;
+
+    for (bn_size_t<container_t> i = 0; i < num.size(); ++i) {
+        carry += (bn_u64_t)num[i] * factor;
+        num[i] = (bn_single)(carry % NUM_BASE);
+        carry /= NUM_BASE;
+    }
+
+    while (carry) {
+        num.push_back((bn_single)(carry % NUM_BASE));
+        carry /= NUM_BASE;
+    }
+}
+
+
+
+template <typename limits_t, typename container_t>
+void abs_val_mul_native(container_t& num, bn_u64_t factor) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    if (factor <= (bn_u64_t{1} << 32)) {
+        abs_val_mul_small<limits_t, container_t>(num, factor);
+        return;
+    }
+
+    if (num.empty()) {
+        return;
+    }
+
+    container_t digits{};
+
+    while (factor) {
+        digits.push_back((bn_single)(factor % NUM_BASE));
+        factor /= NUM_BASE;
+    }
+
+    num = abs_val_mul<limits_t, container_t>(num, digits);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Digit-range addition
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void bn_digits_add(
+    bn_citer_t<container_t> x, bn_size_t<container_t> xLen,
+    bn_citer_t<container_t> y, bn_size_t<container_t> yLen,
+    bn_iter_t<container_t> out
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    const bn_size_t<container_t> maxLen = xLen > yLen ? xLen : yLen;
+    bn_u64_t carry = 0;
+
+    for (bn_size_t<container_t> i = 0; i < maxLen; ++i) {
+        if (i < xLen) { carry += (bn_u64_t)x[i]; }
+        if (i < yLen) { carry += (bn_u64_t)y[i]; }
+
+        out[i] = (bn_single)(carry % NUM_BASE);
+        carry /= NUM_BASE;
+    }
+
+    out[maxLen] = (bn_single)carry;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// In-place digit-range addition
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void bn_digits_add_in_place(
+    bn_iter_t<container_t> x, bn_size_t<container_t> xLen,
+    bn_citer_t<container_t> y, bn_size_t<container_t> yLen
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    // leading zeroes in the addend may extend past the output
+    while (yLen > xLen && !y[yLen-1]) {
+        --yLen;
+    }
+
+    BN_ASSERT(yLen <= xLen);
+
+    bn_u64_t carry = 0;
+    bn_size_t<container_t> i = 0;
+
+    for (; i < yLen; ++i) {
+        carry += (bn_u64_t)x[i] + (bn_u64_t)y[i];
+        x[i] = (bn_single)(carry % NUM_BASE);
+        carry /= NUM_BASE;
+    }
+
+    for (; carry && i < xLen; ++i) {
+        carry += (bn_u64_t)x[i];
+        x[i] = (bn_single)(carry % NUM_BASE);
+        carry /= NUM_BASE;
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// In-place digit-range subtraction
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void bn_digits_sub_in_place(
+    bn_iter_t<container_t> x, bn_size_t<container_t> xLen,
+    bn_citer_t<container_t> y, bn_size_t<container_t> yLen
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    while (yLen > xLen && !y[yLen-1]) {
+        --yLen;
+    }
+
+    BN_ASSERT(yLen <= xLen);
+
+    bn_u64_t borrow = 0;
+    bn_size_t<container_t> i = 0;
+
+    for (; i < yLen; ++i) {
+        const bn_u64_t sub = (bn_u64_t)y[i] + borrow;
+        const bn_u64_t digit = (bn_u64_t)x[i];
+
+        borrow = digit < sub;
+        x[i] = (bn_single)(digit + (borrow ? NUM_BASE : 0) - sub);
+    }
+
+    for (; borrow && i < xLen; ++i) {
+        const bn_u64_t digit = (bn_u64_t)x[i];
+
+        borrow = !digit;
+        x[i] = (bn_single)(borrow ? (NUM_BASE-1) : (digit-1));
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Schoolbook column sums
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Accumulate one product into the sum of a column. Products of digits wider
+ * than 16 bits are split into their low and high digits, so each half of
+ * the sum stays within 64 bits for any practical operand length.
+ */
+template <bn_u64_t NUM_BASE>
+inline void bn_column_add(bn_u64_t& lo, bn_u64_t& hi, bn_u64_t product) {
+    if (NUM_BASE > 0x10000) {
+        lo += product % NUM_BASE;
+        hi += product / NUM_BASE;
+    }
+    else {
+        lo += product;
+    }
+}
+
+
+
+template <typename digit_t>
+void bn_column_sums(
+    const digit_t* x, std::size_t xLen,
+    const digit_t* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    static constexpr bn_u64_t NUM_BASE = bn_max_limit<digit_t>() + 1;
+
+    for (std::size_t k = 0; k + 1 < xLen + yLen; ++k) {
+        const std::size_t first = (k < yLen) ? 0 : k - yLen + 1;
+        const std::size_t last = (k < xLen) ? k + 1 : xLen;
+
+        bn_u64_t sumLo = 0;
+        bn_u64_t sumHi = 0;
+
+        // y[k-i] is stored at yRev[yLen-1-k+i]
+        for (std::size_t i = first; i < last; ++i) {
+            bn_column_add<NUM_BASE>(sumLo, sumHi, (bn_u64_t)x[i] * (bn_u64_t)yRev[yLen-1+i-k]);
+        }
+
+        lo[k] = sumLo;
+        hi[k] = sumHi;
+    }
+}
+
+
+
+template <typename digit_t>
+void bn_column_squares(
+    const digit_t* x, const digit_t* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    static constexpr bn_u64_t NUM_BASE = bn_max_limit<digit_t>() + 1;
+
+    for (std::size_t k = 0; k + 1 < 2*len; ++k) {
+        const std::size_t first = (k < len) ? 0 : k - len + 1;
+        const std::size_t mid = (k + 1) / 2;
+
+        bn_u64_t sumLo = 0;
+        bn_u64_t sumHi = 0;
+
+        for (std::size_t i = first; i < mid; ++i) {
+            bn_column_add<NUM_BASE>(sumLo, sumHi, (bn_u64_t)x[i] * (bn_u64_t)xRev[len-1+i-k]);
+        }
+
+        sumLo *= 2;
+        sumHi *= 2;
+
+        if (!(k & 1)) {
+            bn_column_add<NUM_BASE>(sumLo, sumHi, (bn_u64_t)x[k/2] * (bn_u64_t)x[k/2]);
+        }
+
+        lo[k] = sumLo;
+        hi[k] = sumHi;
+    }
+}
+
+
+
+/*
+ * Resolve the carries of a block of column sums into output digits. The
+ * first "overlap" digits of the output already hold the top of a previous
+ * block, and are added in.
+ */
+template <typename limits_t, typename container_t>
+void bn_column_carry(
+    const bn_u64_t* lo, const bn_u64_t* hi, std::size_t numColumns,
+    bn_iter_t<container_t> out, std::size_t overlap
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    bn_u64_t carry = 0;
+
+    for (std::size_t k = 0; k < numColumns; ++k) {
+        bn_u64_t sum = lo[k] + carry;
+
+        if (k < overlap) {
+            sum += (bn_u64_t)out[k];
+        }
+
+        out[k] = (bn_single)(sum % NUM_BASE);
+        carry = sum / NUM_BASE + hi[k];
+    }
+
+    out[numColumns] = (bn_single)carry;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Schoolbook multiplication kernel
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void mul_schoolbook_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_citer_t<container_t> b, bn_size_t<container_t> bLen,
+    bn_iter_t<container_t> out
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+    static constexpr std::size_t BLOCK_LEN = BN_COLUMN_BLOCK_LEN;
+
+    if (aLen < bLen) {
+        std::swap(a, b);
+        std::swap(aLen, bLen);
+    }
+
+    if (!bLen) {
+        for (bn_size_t<container_t> k = 0; k < aLen; ++k) {
+            out[k] = bn_single{0};
+        }
+
+        return;
+    }
+
+    // Short operands are summed one column at a time, directly from the
+    // input, as are operands which are both longer than a block (only
+    // possible with raised thresholds).
+    if (bLen < BN_COLUMN_MIN_LEN || bLen > BLOCK_LEN) {
+        bn_u64_t carry = 0;
+
+        for (bn_size_t<container_t> k = 0; k < aLen + bLen - 1; ++k) {
+            const bn_size_t<container_t> first = (k < bLen) ? 0 : k - bLen + 1;
+            const bn_size_t<container_t> last = (k < aLen) ? k + 1 : aLen;
+
+            bn_u64_t lo = carry;
+            bn_u64_t hi = 0;
+
+            for (bn_size_t<container_t> i = first; i < last; ++i) {
+                bn_column_add<NUM_BASE>(lo, hi, (bn_u64_t)a[i] * (bn_u64_t)b[k-i]);
+            }
+
+            out[k] = (bn_single)(lo % NUM_BASE);
+            carry = lo / NUM_BASE + hi;
+        }
+
+        out[aLen+bLen-1] = (bn_single)carry;
+        return;
+    }
+
+    // The longer operand is multiplied one block at a time, so the column
+    // sums and both blocks of digits stay in a few kilobytes of the stack.
+    bn_single x[BLOCK_LEN];
+    bn_single yRev[BLOCK_LEN];
+    bn_u64_t lo[2*BLOCK_LEN];
+    bn_u64_t hi[2*BLOCK_LEN];
+
+    for (bn_size_t<container_t> j = 0; j < bLen; ++j) {
+        yRev[j] = b[bLen-1-j];
+    }
+
+    for (bn_size_t<container_t> i0 = 0; i0 < aLen; i0 += BLOCK_LEN) {
+        const std::size_t xLen = (aLen - i0 < BLOCK_LEN) ? aLen - i0 : BLOCK_LEN;
+
+        for (std::size_t i = 0; i < xLen; ++i) {
+            x[i] = a[i0+i];
+        }
+
+        bn_column_sums(x, xLen, yRev, bLen, lo, hi);
+
+        // Earlier blocks have already written the digits below (i0+bLen).
+        bn_column_carry<limits_t, container_t>(lo, hi, xLen+bLen-1, out+i0, i0 ? bLen : 0);
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Schoolbook squaring kernel
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void sqr_schoolbook_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_iter_t<container_t> out
+) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+    static constexpr std::size_t BLOCK_LEN = BN_COLUMN_BLOCK_LEN;
+
+    if (!aLen) {
+        return;
+    }
+
+    // Each column of a square only sums half of its products, so blocks only
+    // pay for themselves at twice the length of a multiplication.
+    if (aLen >= 2*BN_COLUMN_MIN_LEN && aLen <= BLOCK_LEN) {
+        bn_single x[BLOCK_LEN];
+        bn_single xRev[BLOCK_LEN];
+        bn_u64_t lo[2*BLOCK_LEN];
+        bn_u64_t hi[2*BLOCK_LEN];
+
+        for (bn_size_t<container_t> i = 0; i < aLen; ++i) {
+            x[i] = a[i];
+            xRev[aLen-1-i] = a[i];
+        }
+
+        bn_column_squares(x, xRev, aLen, lo, hi);
+        bn_column_carry<limits_t, container_t>(lo, hi, 2*aLen-1, out, 0);
+        return;
+    }
+
+    bn_u64_t carry = 0;
+
+    for (bn_size_t<container_t> k = 0; k < 2*aLen - 1; ++k) {
+        const bn_size_t<container_t> first = (k < aLen) ? 0 : k - aLen + 1;
+
+        bn_u64_t lo = 0;
+        bn_u64_t hi = 0;
+
+        for (bn_size_t<container_t> i = first; i < k - i; ++i) {
+            bn_column_add<NUM_BASE>(lo, hi, (bn_u64_t)a[i] * (bn_u64_t)a[k-i]);
+        }
+
+        lo = 2*lo + carry;
+        hi = 2*hi;
+
+        if (!(k & 1)) {
+            bn_column_add<NUM_BASE>(lo, hi, (bn_u64_t)a[k/2] * (bn_u64_t)a[k/2]);
+        }
+
+        out[k] = (bn_single)(lo % NUM_BASE);
+        carry = lo / NUM_BASE + hi;
+    }
+
+    out[2*aLen-1] = (bn_single)carry;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Karatsuba multiplication kernel
+///////////////////////////////////////////////////////////////////////////////
+template <typename container_t>
+bn_size_t<container_t> mul_karatsuba_scratch(bn_size_t<container_t> len) {
+    bn_size_t<container_t> ret = 0;
+
+    // Each level needs two half-length sums and their product, then recurses
+    // on operands one digit longer than half the current length.
+    while (len >= 4) {
+        const bn_size_t<container_t> half = (len + 1) / 2;
+        ret += 4 * half + 4;
+        len = half + 1;
+    }
+
+    return ret;
+}
+
+
+
+template <typename limits_t, typename container_t>
+void mul_karatsuba_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_citer_t<container_t> b, bn_size_t<container_t> bLen,
+    bn_iter_t<container_t> out,
+    bn_iter_t<container_t> scratch
+) {
+    typedef typename limits_t::base_single bn_single;
+
+    if (aLen < bLen) {
+        std::swap(a, b);
+        std::swap(aLen, bLen);
+    }
+
+    // Operands of less than 4 digits cannot be split any further.
+    if (bLen < 4 || bLen < BNThresholds<limits_t>::mulKaratsuba) {
+        mul_schoolbook_kernel<limits_t, container_t>(a, aLen, b, bLen, out);
+        return;
+    }
+
+    const bn_size_t<container_t> half = (aLen + 1) / 2;
+    const bn_size_t<container_t> a1Len = aLen - half;
+
+    // The shorter operand only overlaps the low half of the longer one:
+    // a*b = a0*b + (a1*b)*base^half
+    if (bLen <= half) {
+        const bn_size_t<container_t> hiLen = a1Len + bLen;
+
+        mul_karatsuba_kernel<limits_t, container_t>(a, half, b, bLen, out, scratch);
+        mul_karatsuba_kernel<limits_t, container_t>(a+half, a1Len, b, bLen, scratch, scratch+hiLen);
+
+        for (bn_size_t<container_t> i = half + bLen; i < aLen + bLen; ++i) {
+            out[i] = bn_single{0};
+        }
+
+        bn_digits_add_in_place<limits_t, container_t>(out+half, aLen+bLen-half, scratch, hiLen);
+        return;
+    }
+
+    const bn_size_t<container_t> b1Len = bLen - half;
+
+    // z0 = a0*b0 and z2 = a1*b1 are placed directly in the output
+    mul_karatsuba_kernel<limits_t, container_t>(a, half, b, half, out, scratch);
+    mul_karatsuba_kernel<limits_t, container_t>(a+half, a1Len, b+half, b1Len, out+2*half, scratch);
+
+    // z1 = (a0+a1)*(b0+b1) - z0 - z2
+    const bn_iter_t<container_t> sumA = scratch;
+    const bn_iter_t<container_t> sumB = sumA + (half+1);
+    const bn_iter_t<container_t> z1 = sumB + (half+1);
+    const bn_iter_t<container_t> next = z1 + 2*(half+1);
+
+    bn_digits_add<limits_t, container_t>(a, half, a+half, a1Len, sumA);
+    bn_digits_add<limits_t, container_t>(b, half, b+half, b1Len, sumB);
+    mul_karatsuba_kernel<limits_t, container_t>(sumA, half+1, sumB, half+1, z1, next);
+
+    bn_digits_sub_in_place<limits_t, container_t>(z1, 2*(half+1), out, 2*half);
+    bn_digits_sub_in_place<limits_t, container_t>(z1, 2*(half+1), out+2*half, a1Len+b1Len);
+    bn_digits_add_in_place<limits_t, container_t>(out+half, aLen+bLen-half, z1, 2*(half+1));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Karatsuba squaring kernel
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+void sqr_karatsuba_kernel(
+    bn_citer_t<container_t> a, bn_size_t<container_t> aLen,
+    bn_iter_t<container_t> out,
+    bn_iter_t<container_t> scratch
+) {
+    if (aLen < 4 || aLen < BNThresholds<limits_t>::sqrKaratsuba) {
+        sqr_schoolbook_kernel<limits_t, container_t>(a, aLen, out);
+        return;
+    }
+
+    const bn_size_t<container_t> half = (aLen + 1) / 2;
+    const bn_size_t<container_t> a1Len = aLen - half;
+
+    // z0 = a0^2 and z2 = a1^2 are placed directly in the output
+    sqr_karatsuba_kernel<limits_t, container_t>(a, half, out, scratch);
+    sqr_karatsuba_kernel<limits_t, container_t>(a+half, a1Len, out+2*half, scratch);
+
+    // z1 = (a0+a1)^2 - z0 - z2
+    const bn_iter_t<container_t> sumA = scratch;
+    const bn_iter_t<container_t> z1 = sumA + (half+1);
+    const bn_iter_t<container_t> next = z1 + 2*(half+1);
+
+    bn_digits_add<limits_t, container_t>(a, half, a+half, a1Len, sumA);
+    sqr_karatsuba_kernel<limits_t, container_t>(sumA, half+1, z1, next);
+
+    bn_digits_sub_in_place<limits_t, container_t>(z1, 2*(half+1), out, 2*half);
+    bn_digits_sub_in_place<limits_t, container_t>(z1, 2*(half+1), out+2*half, 2*a1Len);
+    bn_digits_add_in_place<limits_t, container_t>(out+half, 2*aLen-half, z1, 2*(half+1));
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Toom-Cook signed arithmetic
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Add a signed magnitude to a signed value. abs_val_sub() requires its first
+ * operand to be the larger of the two, so mixed signs subtract the smaller
+ * magnitude from the larger one.
+ */
+template <typename limits_t, typename container_t>
+void toom_accumulate(BNToomValue<container_t>& x, const container_t& y, bool yNegative) {
+    if (y.empty()) {
+        return;
+    }
+
+    if (x.digits.empty()) {
+        x.digits = y;
+        x.negative = yNegative;
+        return;
+    }
+
+    if (x.negative == yNegative) {
+        abs_val_add<limits_t, container_t>(x.digits, y);
+        return;
+    }
+
+    if (abs_val_is_ge<container_t>(x.digits, y)) {
+        abs_val_sub<limits_t, container_t>(x.digits, y);
+    }
+    else {
+        container_t diff = y;
+        abs_val_sub<limits_t, container_t>(diff, x.digits);
+        x.digits = std::move(diff);
+        x.negative = yNegative;
+    }
+
+    if (x.digits.empty()) {
+        x.negative = false;
+    }
+}
+
+
+
+template <typename limits_t, typename container_t>
+void toom_add(BNToomValue<container_t>& x, const BNToomValue<container_t>& y) {
+    toom_accumulate<limits_t, container_t>(x, y.digits, y.negative);
+}
+
+
+
+template <typename limits_t, typename container_t>
+void toom_sub(BNToomValue<container_t>& x, const BNToomValue<container_t>& y) {
+    toom_accumulate<limits_t, container_t>(x, y.digits, !y.negative);
+}
+
+
+
+template <typename limits_t, typename container_t>
+void toom_mul_small(BNToomValue<container_t>& x, bn_u64_t factor) {
+    abs_val_mul_small<limits_t, container_t>(x.digits, factor);
+
+    if (x.digits.empty()) {
+        x.negative = false;
+    }
+}
+
+
+
+template <typename limits_t, typename container_t>
+void toom_div_exact(BNToomValue<container_t>& x, bn_u64_t divisor) {
+    const bn_u64_t rem = abs_val_div_small<limits_t, container_t>(x.digits, divisor);
+
+    BN_ASSERT(rem == 0);
+    (void)rem;
+
+    if (x.digits.empty()) {
+        x.negative = false;
+    }
+}
+
+
+
+template <typename limits_t, typename container_t>
+BNToomValue<container_t> toom_mul(const BNToomValue<container_t>& x, const BNToomValue<container_t>& y) {
+    BNToomValue<container_t> ret{x.negative != y.negative, abs_val_mul<limits_t, container_t>(x.digits, y.digits)};
+
+    if (ret.digits.empty()) {
+        ret.negative = false;
+    }
+
+    return ret;
+}
+
+
+
+template <typename limits_t, typename container_t>
+container_t toom_recompose(const BNToomValue<container_t>* coeffs, unsigned numCoeffs, bn_size_t<container_t> k) {
+    BN_ASSERT(!coeffs[0].negative);
+
+    container_t ret = coeffs[0].digits;
+
+    for (unsigned i = 1; i < numCoeffs; ++i) {
+        BN_ASSERT(!coeffs[i].negative);
+        abs_val_add_shifted<limits_t, container_t>(ret, coeffs[i].digits, i*k);
+    }
+
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
@@ -0,0 +1,97 @@
+/* 
+ * File:   bn_multiplier_impl.h
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Construction
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+BignumMultiplier<limits_t, container_t>::BignumMultiplier(const bignum_type& num) :
+    factor{num}
+{}
+
+template <class limits_t, class container_t>
+BignumMultiplier<limits_t, container_t>::BignumMultiplier(bignum_type&& num) :
+    factor{std::move(num)}
+{}
+
+///////////////////////////////////////////////////////////////////////////////
+// Factor access
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline const typename BignumMultiplier<limits_t, container_t>::bignum_type&
+BignumMultiplier<limits_t, container_t>::getFactor() const {
+    return factor;
+}
+
+template <class limits_t, class container_t>
+void BignumMultiplier<limits_t, container_t>::clearCache() {
+    numPieces = 0;
+    spectrum = BNRealSpectrum<double>{};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Transform management
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+bool BignumMultiplier<limits_t, container_t>::prepare(typename container_t::size_type numDigits, bool chunked) {
+    const typename container_t::size_type factorLen = factor.numData.size();
+
+    const unsigned pieces = fft_num_pieces<double>(limits_t::SINGLE_BASE_MAX, numDigits, factorLen);
+
+    if (!pieces) {
+        return false;
+    }
+
+    const cmplx_size_t<double> fftSize = chunked
+        ? fft_real_length<double>(2 * factorLen * pieces)
+        : fft_real_length<double>((numDigits + factorLen) * pieces);
+
+    // The transform can be reused as long as neither the length nor the way
+    // digits are split has changed.
+    if (pieces != numPieces || fftSize != spectrum.fftSize) {
+        const unsigned pieceBits = (unsigned)bn_bit_width(limits_t::SINGLE_BASE_MAX) / pieces;
+
+        cmplx_list_t<double> fftTable = create_fft_real_table<container_t, double>(factor.numData, fftSize, pieces, pieceBits);
+
+        spectrum = fft_real_spectrum<double>(fftTable);
+        numPieces = pieces;
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiplication
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+typename BignumMultiplier<limits_t, container_t>::bignum_type
+BignumMultiplier<limits_t, container_t>::multiply(const bignum_type& num) {
+    const typename container_t::size_type numLen = num.numData.size();
+    const typename container_t::size_type factorLen = factor.numData.size();
+    const typename container_t::size_type minLen = numLen < factorLen ? numLen : factorLen;
+
+    // Follows the same rule as abs_val_mul(), except that only the number
+    // can be split into chunks.
+    const bool chunked = factorLen >= BNThresholds<limits_t>::mulUnbalanced && numLen >= 4 * factorLen;
+
+    bignum_type ret = num;
+
+    // Short or special-valued operands gain nothing from a stored transform
+    if (!bignum_type::isComputable(num.descriptor)
+    || !bignum_type::isComputable(factor.descriptor)
+    || minLen < BNThresholds<limits_t>::mulFFT
+    || !prepare(numLen, chunked)
+    ) {
+        ret *= factor;
+        return ret;
+    }
+
+    ret.descriptor = (num.descriptor == factor.descriptor) ? BN_POS : BN_NEG;
+
+    ret.numData = chunked
+        ? mul_strassen_spectrum_unbalanced<limits_t, container_t, double>(num.numData, factorLen, spectrum, numPieces)
+        : mul_strassen_spectrum<limits_t, container_t, double>(num.numData, spectrum, numPieces);
+
+    return ret;
+}
@@ -71,3 +71,18 @@ void abs_val_sub(
     }
 }
 
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Leading-zero removal
+///////////////////////////////////////////////////////////////////////////////
+template <class container_t>
+void abs_val_trim(container_t& num) {
+    typename container_t::size_type numDigits = num.size();
+
+    while (numDigits && !num[numDigits-1]) {
+        --numDigits;
+    }
+
+    num.resize(numDigits);
+}
@@ -0,0 +1,92 @@
+/* 
+ * File:   bn_thresholds_impl.h
+ */
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Default multiplication thresholds
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::mulKaratsuba = 32;
+
+/*
+ * Schoolbook squaring computes half as many products, so it stays ahead of
+ * Karatsuba for longer.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::sqrKaratsuba = 48;
+
+/*
+ * Toom-Cook only pays for its evaluation and interpolation overhead once
+ * the recursive products are well past the Karatsuba threshold.
+ * 
+ * Both defaults lie above mulFFT, which is checked first, so Toom-Cook is
+ * off by default for every built-in type. On the machines measured, the
+ * transforms were 2 to 10 times faster than Toom-3 and Toom-4 at every
+ * length from 128 to 8192 digits. These only take effect when mulFFT is
+ * raised above them.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::mulToom3 = 512;
+
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::mulToom4 = 2048;
+
+/*
+ * Wider digits are split into smaller fields for an exact transform, which
+ * pushes the crossover point further out.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::mulFFT =
+    (limits_t::SINGLE_BASE_MAX > 0xFFFF) ? 256
+    : 128;
+
+/*
+ * Each chunk runs a separate transform about twice the length of the
+ * shorter operand, which only saves time over a single transform of the
+ * whole product once those transforms are long enough to leave the cache.
+ * Narrow digits pack more of themselves into each transform value.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::mulUnbalanced =
+    (limits_t::SINGLE_BASE_MAX >= 0xFF) ? 1024
+    : 4096;
+
+///////////////////////////////////////////////////////////////////////////////
+// Default division thresholds
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * The recursion only pays off once its halves are long enough to use
+ * Karatsuba's method.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::divBurnikel = 96;
+
+/*
+ * Newton's method costs a few more multiplications than the recursive
+ * division, and only overtakes it once those multiplications use
+ * transforms. Wide digits are split into the most pieces for a transform,
+ * so they need the longest operands.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::divNewton =
+    (limits_t::SINGLE_BASE_MAX > 0xFFFF) ? 65536
+    : (limits_t::SINGLE_BASE_MAX >= 0xFF) ? 1024
+    : 384;
+
+/*
+ * A stored reciprocal saves the cost of Newton's method, leaving two
+ * multiplications for each block of quotient digits.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::divBarrett = 128;
+
+/*
+ * Splitting exact division costs a multiplication and some copies at each
+ * level, which only pay off with Karatsuba-sized halves.
+ */
+template <typename limits_t>
+std::size_t BNThresholds<limits_t>::divExact =
+    (limits_t::SINGLE_BASE_MAX >= 0xFF) ? 128
+    : 64;
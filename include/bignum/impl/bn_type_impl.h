@@ -69,7 +69,7 @@ Bignum<limits_t, container_t>::Bignum(
     typename container_t::size_type leadingZeroes = 0;
 
     // count all of the digits, minus starting "zeroes"
-    for (const auto val : numList) {
+    for (const auto& val : numList) {
         if (val != (bn_single)limits_t::SINGLE_BASE_MIN)
         {
             break;
@@ -81,7 +81,7 @@ Bignum<limits_t, container_t>::Bignum(
     numData.resize(numList.size() - leadingZeroes);
     typename container_t::size_type outIter = numData.size();
 
-    for (const auto val : numList)
+    for (const auto& val : numList)
     {
         if (leadingZeroes)
         {
@@ -435,6 +435,29 @@ Bignum<limits_t, container_t>::operator * (const Bignum& num) const {
     return ret;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Multiply by a digit.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>
+Bignum<limits_t, container_t>::operator * (bn_single digit) const {
+    Bignum ret = *this;
+    ret *= digit;
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiply by a native integer.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+template <typename int_t>
+inline typename std::enable_if<std::is_unsigned<int_t>::value, Bignum<limits_t, container_t>>::type
+Bignum<limits_t, container_t>::operator * (int_t factor) const {
+    Bignum ret = *this;
+    ret *= factor;
+    return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Divide.
 ///////////////////////////////////////////////////////////////////////////////
@@ -446,6 +469,63 @@ Bignum<limits_t, container_t>::operator / (const Bignum& num) const {
     return ret;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Modulo
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>
+Bignum<limits_t, container_t>::operator % (const Bignum& num) const {
+    Bignum ret = *this;
+    ret %= num;
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Divide by a digit.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>
+Bignum<limits_t, container_t>::operator / (bn_single digit) const {
+    Bignum ret = *this;
+    ret /= digit;
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Divide by a native integer.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+template <typename int_t>
+inline typename std::enable_if<std::is_unsigned<int_t>::value, Bignum<limits_t, container_t>>::type
+Bignum<limits_t, container_t>::operator / (int_t divisor) const {
+    Bignum ret = *this;
+    ret /= divisor;
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Modulo by a digit.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>
+Bignum<limits_t, container_t>::operator % (bn_single digit) const {
+    Bignum ret = *this;
+    ret %= digit;
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Modulo by a native integer.
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+template <typename int_t>
+inline typename std::enable_if<std::is_unsigned<int_t>::value, Bignum<limits_t, container_t>>::type
+Bignum<limits_t, container_t>::operator % (int_t divisor) const {
+    Bignum ret = *this;
+    ret %= divisor;
+    return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Addition with assignment
 ///////////////////////////////////////////////////////////////////////////////
@@ -591,6 +671,12 @@ template <class limits_t, class container_t>
 Bignum<limits_t, container_t>&
 Bignum<limits_t, container_t>::operator *=(const Bignum& num) {
 
+    // self-multiplication, including infinities which square to positive
+    // infinity
+    if (&num == this) {
+        return sqr();
+    }
+
     // Make sure no unneeded calculations are performed
     if (!isComputable(descriptor)) {
         numData.clear();
@@ -616,8 +702,22 @@ Bignum<limits_t, container_t>::operator *=(const Bignum& num) {
 
     // std::deque throws exceptions when a memory error occurs
     try {
-        ret.numData = std::move(mul_strassen<limits_t, container_t>(numData, num.numData));
-        *this = std::move(ret);
+        // A single-digit operand is multiplied in-place, without allocating
+        // a separate product
+        if (num.numData.size() == 1) {
+            abs_val_mul_small<limits_t, container_t>(numData, (bn_u64_t)num.numData[0]);
+            descriptor = ret.descriptor;
+        }
+        else if (numData.size() == 1 && !num.numData.empty()) {
+            const bn_u64_t factor = (bn_u64_t)numData[0];
+            numData = num.numData;
+            abs_val_mul_small<limits_t, container_t>(numData, factor);
+            descriptor = ret.descriptor;
+        }
+        else {
+            ret.numData = abs_val_mul<limits_t, container_t>(numData, num.numData);
+            *this = std::move(ret);
+        }
     }
     catch(const std::exception& e) {
         // Mark the number as positive infinite as this was likely the cause of an allocation failure.
@@ -632,21 +732,150 @@ Bignum<limits_t, container_t>::operator *=(const Bignum& num) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// Division with assignment
+// Multiplication by a digit with assignment
 ///////////////////////////////////////////////////////////////////////////////
 template <class limits_t, class container_t>
 Bignum<limits_t, container_t>&
-Bignum<limits_t, container_t>::operator /=(const Bignum& num) {
+Bignum<limits_t, container_t>::operator *=(bn_single digit) {
+
+    // Infinities and NaN keep their descriptor
+    if (!isComputable(descriptor)) {
+        numData.clear();
+        return *this;
+    }
+
+    // std::deque throws exceptions when a memory error occurs
+    try {
+        abs_val_mul_small<limits_t, container_t>(numData, (bn_u64_t)digit);
+    }
+    catch(const std::exception& e) {
+        descriptor = (descriptor == BN_POS) ? BN_POS_INF : BN_NEG_INF;
+
+        numData.clear();
+
+        throw e;
+    }
+
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiplication by a native integer with assignment
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+template <typename int_t>
+typename std::enable_if<std::is_unsigned<int_t>::value, Bignum<limits_t, container_t>&>::type
+Bignum<limits_t, container_t>::operator *=(int_t factor) {
+
+    // Infinities and NaN keep their descriptor
+    if (!isComputable(descriptor)) {
+        numData.clear();
+        return *this;
+    }
+
+    // std::deque throws exceptions when a memory error occurs
+    try {
+        abs_val_mul_native<limits_t, container_t>(numData, (bn_u64_t)factor);
+    }
+    catch(const std::exception& e) {
+        descriptor = (descriptor == BN_POS) ? BN_POS_INF : BN_NEG_INF;
+
+        numData.clear();
+
+        throw e;
+    }
+
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Square
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>
+Bignum<limits_t, container_t>::square() const {
+    Bignum ret = *this;
+    ret.sqr();
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Square with assignment
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+Bignum<limits_t, container_t>&
+Bignum<limits_t, container_t>::sqr() {
+
+    // Infinities square to positive infinity, NaN remains NaN
+    if (!isComputable(descriptor)) {
+        numData.clear();
+
+        if (descriptor == BN_NEG_INF) {
+            descriptor = BN_POS_INF;
+        }
+
+        return *this;
+    }
+
+    // std::deque throws exceptions when a memory error occurs
+    try {
+        numData = abs_val_sqr<limits_t, container_t>(numData);
+        descriptor = BN_POS;
+    }
+    catch(const std::exception& e) {
+        descriptor = BN_POS_INF;
+
+        numData.clear();
+
+        throw e;
+    }
+
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Division with remainder
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+Bignum<limits_t, container_t>&
+Bignum<limits_t, container_t>::divmod(const Bignum& num, Bignum& remainder) {
+
+    // The remainder may be the same object as *this or the divisor, so it is
+    // only written once the division is done.
+    Bignum rem;
+    rem.descriptor = BN_NAN;
 
     // Make sure no unneeded calculations are performed
     if (!isComputable(descriptor)) {
         numData.clear();
         descriptor = num.descriptor;
+        remainder = std::move(rem);
+        return *this;
+    }
+
+    // A finite number divided by an infinite one truncates to zero, with the
+    // number itself as the remainder.
+    if (!isComputable(num.descriptor)) {
+        if (num.descriptor != BN_NAN) {
+            rem = std::move(*this);
+            numData = {bn_single{0}};
+            descriptor = BN_POS;
+        }
+        else {
+            numData.clear();
+            descriptor = BN_NAN;
+        }
+
+        remainder = std::move(rem);
         return *this;
     }
 
     static constexpr bn_double SINGLE_BASE_MIN = bn_min_limit<bn_single>();
-    
+
+    // The quotient is truncated towards zero, so the remainder takes the
+    // sign of the dividend.
+    const bn_desc_t remDescriptor = descriptor;
+
     // subtract a negative from a positive
     if (this->descriptor == BN_POS && num.descriptor == BN_NEG) {
         descriptor = BN_NEG;
@@ -661,46 +890,241 @@ Bignum<limits_t, container_t>::operator /=(const Bignum& num) {
         descriptor = BN_POS;
     }
 
-    if (num.numData.size() == 1 && num.numData[0] == SINGLE_BASE_MIN)
+    if (num.numData.empty() || (num.numData.size() == 1 && num.numData[0] == SINGLE_BASE_MIN))
     {
         numData.clear();
         descriptor = descriptor == BN_NEG ? BN_NEG_INF : BN_POS_INF;
+        remainder = std::move(rem);
         return *this;
     }
 
-    if (num.numData.size() == 1 && num.numData[0] == (bn_single)1)
+    // std::deque throws exceptions when a memory error occurs
+    try {
+        // The division trims both operands before comparing them, and copies
+        // the divisor before writing to numData
+        abs_val_divmod<limits_t, container_t>(numData, num.numData, rem.numData);
+    }
+    catch(const std::exception& e) {
+        // Mark the number as positive infinite as this was likely the cause of an allocation failure.
+        descriptor = (num.descriptor == BN_POS) ? BN_POS_INF : BN_NEG_INF;
+        
+        numData.clear();
+        
+        throw e;
+    }
+
+    if (numData.empty())
     {
-        return *this;
+        numData = {bn_single{0}};
+        descriptor = BN_POS;
     }
 
-    if (numData.empty() || (numData.size() == 1 && numData[0] == SINGLE_BASE_MIN))
+    if (rem.numData.empty())
     {
-        return *this;
+        rem.numData = {bn_single{0}};
+        rem.descriptor = BN_POS;
+    }
+    else
+    {
+        rem.descriptor = remDescriptor;
     }
 
+    remainder = std::move(rem);
+
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Division by a native integer with remainder
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+inline bn_u64_t
+Bignum<limits_t, container_t>::divmod_small(bn_single digit) {
+    return divmod_small((bn_u64_t)digit);
+}
+
+template <class limits_t, class container_t>
+template <typename int_t>
+typename std::enable_if<std::is_unsigned<int_t>::value, bn_u64_t>::type
+Bignum<limits_t, container_t>::divmod_small(int_t divisor) {
+
+    // Infinities and NaN keep their descriptor
+    if (!isComputable(descriptor)) {
+        numData.clear();
+        return 0;
+    }
+
+    if (!divisor) {
+        numData.clear();
+        descriptor = (descriptor == BN_NEG) ? BN_NEG_INF : BN_POS_INF;
+        return 0;
+    }
+
+    bn_u64_t rem = 0;
+
     // std::deque throws exceptions when a memory error occurs
     try {
-        if (abs_val_is_gt(numData, num.numData))
-        {
-            abs_val_div<limits_t, container_t>(numData, num.numData);
-        }
-        else
-        {
-            numData = {bn_single{0}};
-        }
+        rem = abs_val_div_native<limits_t, container_t>(numData, (bn_u64_t)divisor);
     }
     catch(const std::exception& e) {
-        // Mark the number as positive infinite as this was likely the cause of an allocation failure.
-        descriptor = (num.descriptor == BN_POS) ? BN_POS_INF : BN_NEG_INF;
-        
+        descriptor = (descriptor == BN_POS) ? BN_POS_INF : BN_NEG_INF;
+
         numData.clear();
-        
+
         throw e;
     }
 
+    // Trimming never releases memory, so a zero digit can be stored again
+    // without allocating.
+    if (numData.empty()) {
+        numData.push_back(bn_single{0});
+        descriptor = BN_POS;
+    }
+
+    return rem;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Division with assignment
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+Bignum<limits_t, container_t>&
+Bignum<limits_t, container_t>::operator /=(const Bignum& num) {
+    static constexpr bn_double SINGLE_BASE_MIN = bn_min_limit<bn_single>();
+
+    // Single-digit divisors need no remainder, or any other containers
+    if (isComputable(descriptor)
+    && isComputable(num.descriptor)
+    && num.numData.size() == 1
+    && num.numData[0] != SINGLE_BASE_MIN
+    ) {
+        divmod_small(num.numData[0]);
+
+        if (num.descriptor == BN_NEG && !(numData.size() == 1 && numData[0] == SINGLE_BASE_MIN)) {
+            descriptor = (descriptor == BN_POS) ? BN_NEG : BN_POS;
+        }
+
+        return *this;
+    }
+
+    Bignum remainder;
+    return divmod(num, remainder);
+}
+
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>&
+Bignum<limits_t, container_t>::operator /=(bn_single digit) {
+    divmod_small(digit);
     return *this;
 }
 
+template <class limits_t, class container_t>
+template <typename int_t>
+inline typename std::enable_if<std::is_unsigned<int_t>::value, Bignum<limits_t, container_t>&>::type
+Bignum<limits_t, container_t>::operator /=(int_t divisor) {
+    divmod_small(divisor);
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Modulo with assignment
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+Bignum<limits_t, container_t>&
+Bignum<limits_t, container_t>::operator %=(const Bignum& num) {
+    static constexpr bn_double SINGLE_BASE_MIN = bn_min_limit<bn_single>();
+
+    // The remainder takes the sign of *this, so the divisor's sign is unused
+    if (isComputable(num.descriptor)
+    && num.numData.size() == 1
+    && num.numData[0] != SINGLE_BASE_MIN
+    ) {
+        return *this %= num.numData[0];
+    }
+
+    Bignum remainder;
+    divmod(num, remainder);
+    *this = std::move(remainder);
+    return *this;
+}
+
+template <class limits_t, class container_t>
+inline Bignum<limits_t, container_t>&
+Bignum<limits_t, container_t>::operator %=(bn_single digit) {
+    return *this %= (bn_u64_t)digit;
+}
+
+template <class limits_t, class container_t>
+template <typename int_t>
+typename std::enable_if<std::is_unsigned<int_t>::value, Bignum<limits_t, container_t>&>::type
+Bignum<limits_t, container_t>::operator %=(int_t divisor) {
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    if (!isComputable(descriptor) || !divisor) {
+        numData.clear();
+        descriptor = BN_NAN;
+        return *this;
+    }
+
+    const bn_desc_t remDescriptor = descriptor;
+    bn_u64_t rem = divmod_small(divisor);
+
+    // The quotient's digits are reused for the remainder
+    numData.clear();
+    descriptor = rem ? remDescriptor : BN_POS;
+
+    do {
+        numData.push_back((bn_single)(rem % NUM_BASE));
+        rem /= NUM_BASE;
+    } while (rem);
+
+    return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Division with remainder of two numbers
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+std::pair<Bignum<limits_t, container_t>, Bignum<limits_t, container_t>>
+divmod(const Bignum<limits_t, container_t>& dividend, const Bignum<limits_t, container_t>& divisor) {
+    std::pair<Bignum<limits_t, container_t>, Bignum<limits_t, container_t>> ret{dividend, Bignum<limits_t, container_t>{}};
+    ret.first.divmod(divisor, ret.second);
+    return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Exact division of two numbers
+///////////////////////////////////////////////////////////////////////////////
+template <class limits_t, class container_t>
+Bignum<limits_t, container_t>
+divexact(const Bignum<limits_t, container_t>& dividend, const Bignum<limits_t, container_t>& divisor) {
+    typedef typename limits_t::base_single bn_single;
+
+    Bignum<limits_t, container_t> ret = dividend;
+
+    // Special values and division by zero follow the division operator
+    if (!Bignum<limits_t, container_t>::isComputable(dividend.descriptor)
+    || !Bignum<limits_t, container_t>::isComputable(divisor.descriptor)
+    || divisor.numData.empty()
+    || (divisor.numData.size() == 1 && !divisor.numData[0])
+    ) {
+        ret /= divisor;
+        return ret;
+    }
+
+    abs_val_divexact<limits_t, container_t>(ret.numData, divisor.numData);
+
+    if (ret.numData.empty()) {
+        ret.numData = {bn_single{0}};
+        ret.descriptor = BN_POS;
+    }
+    else {
+        ret.descriptor = (dividend.descriptor == divisor.descriptor) ? BN_POS : BN_NEG;
+    }
+
+    return ret;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Computation sanity check
 ///////////////////////////////////////////////////////////////////////////////
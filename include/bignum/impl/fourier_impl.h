@@ -37,51 +37,715 @@ num_t nextPow2(num_t n) {
 
 
 
+/*
+ * Odd factor of a transform length: 1 for powers of 2, otherwise the radix of
+ * the final pass.
+ */
+template <typename num_t>
+constexpr num_t fft_radix(const num_t n) {
+    return n ? n / (n & (~n + 1)) : 1;
+}
+
+
+
+template <typename flt_t>
+cmplx_size_t<flt_t> fft_length(cmplx_size_t<flt_t> n) {
+    cmplx_size_t<flt_t> ret = nextPow2(n);
+
+    // A mixed-radix length needs at least 4 values per block, which keeps
+    // both it and half of it compatible with the radix-4 pass.
+    for (cmplx_size_t<flt_t> radix : {3, 5}) {
+        const cmplx_size_t<flt_t> blockLen = nextPow2((n + radix - 1) / radix);
+
+        if (blockLen >= 4 && blockLen * radix < ret) {
+            ret = blockLen * radix;
+        }
+    }
+
+    return ret;
+}
+
+
+
+/*
+ * Number of tasks a transform of a given length is divided into.
+ */
+inline std::size_t fft_num_tasks(std::size_t len) {
+    return (len >= fft_parallel_length()) ? fft_num_threads() : 1;
+}
+
+
+
+/*
+ * Length of the chunks made by fft_parallel_chunks(). Every chunk except the
+ * last holds this many values.
+ */
+inline std::size_t fft_chunk_length(std::size_t numTasks, std::size_t len, std::size_t align) {
+    const std::size_t chunkLen = (len + numTasks - 1) / numTasks;
+    return ((chunkLen + align - 1) / align) * align;
+}
+
+
+
+/*
+ * Divide the range [0, len) into at most numTasks contiguous chunks, with
+ * every chunk except the last a multiple of align values, then call
+ * fn(begin, end) for each chunk using fft_parallel_for().
+ */
+template <typename function_t>
+void fft_parallel_chunks(std::size_t numTasks, std::size_t len, std::size_t align, const function_t& fn) {
+    const std::size_t chunkLen = fft_chunk_length(numTasks, len, align);
+
+    if (numTasks < 2 || chunkLen >= len) {
+        fn(std::size_t{0}, len);
+        return;
+    }
+
+    fft_parallel_for((len + chunkLen - 1) / chunkLen, [&](std::size_t t) {
+        const std::size_t begin = t * chunkLen;
+        fn(begin, (begin + chunkLen < len) ? begin + chunkLen : len);
+    });
+}
+
+
+
+/*
+ * Shared storage for the cached twiddle-factor tables of each floating-point
+ * type.
+ */
+template <typename flt_t>
+struct BNFourierCache {
+    std::mutex lock;
+    std::map<cmplx_size_t<flt_t>, cmplx_table_t<flt_t>> roots;
+
+    static BNFourierCache& instance() {
+        static BNFourierCache cache;
+        return cache;
+    }
+};
+
+
+
+template <typename flt_t>
+cmplx_table_t<flt_t> fft_roots(cmplx_size_t<flt_t> len) {
+    static constexpr double pi = 3.1415926535897932384626433832795;
+
+    BNFourierCache<flt_t>& cache = BNFourierCache<flt_t>::instance();
+
+    {
+        std::lock_guard<std::mutex> guard{cache.lock};
+        const auto iter = cache.roots.find(len);
+
+        if (iter != cache.roots.end()) {
+            return iter->second;
+        }
+    }
+
+    // Build the table outside of the lock so other transforms aren't stalled.
+    // Roots are evaluated in double precision regardless of flt_t, and each
+    // pass gets its own contiguous run of factors.
+    const cmplx_size_t<flt_t> radix = fft_radix(len);
+    const cmplx_size_t<flt_t> blockLen = len / radix;
+
+    std::shared_ptr<cmplx_list_t<flt_t>> table{new cmplx_list_t<flt_t>{}};
+    table->resize(len ? (len-1) + (radix-1)*blockLen : 0);
+
+    for (cmplx_size_t<flt_t> span = 1; span < blockLen; span <<= 1) {
+        for (cmplx_size_t<flt_t> k = 0; k < span; ++k) {
+            const double w = -pi * (double)k / (double)span;
+            table->re[span-1+k] = (flt_t)std::cos(w);
+            table->im[span-1+k] = (flt_t)std::sin(w);
+        }
+    }
+
+    // The first half of the roots of unity are already in place for powers
+    // of 2, as the factors of the last pass.
+    if (radix > 1) {
+        for (cmplx_size_t<flt_t> k = 0; k < len/2; ++k) {
+            const double w = -2.0 * pi * (double)k / (double)len;
+            table->re[len/2-1+k] = (flt_t)std::cos(w);
+            table->im[len/2-1+k] = (flt_t)std::sin(w);
+        }
+    }
+
+    for (cmplx_size_t<flt_t> r = 1; r < radix; ++r) {
+        const cmplx_size_t<flt_t> offset = (len-1) + (r-1)*blockLen;
+
+        for (cmplx_size_t<flt_t> k = 0; k < blockLen; ++k) {
+            const double w = -2.0 * pi * (double)(r*k) / (double)len;
+            table->re[offset+k] = (flt_t)std::cos(w);
+            table->im[offset+k] = (flt_t)std::sin(w);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard{cache.lock};
+
+    // Another thread may have finished the same table first.
+    return cache.roots.emplace(len, std::move(table)).first->second;
+}
+
+
+
+template <typename flt_t>
+void fft_clear_roots() {
+    BNFourierCache<flt_t>& cache = BNFourierCache<flt_t>::instance();
+    std::lock_guard<std::mutex> guard{cache.lock};
+    cache.roots.clear();
+
+    fft_clear_scratch<flt_t>();
+}
+
+
+
+/*
+ * Reorder a list of complex numbers by the bit-reversed value of each index.
+ * This is the input permutation required by the in-place radix-2 transform.
+ */
+template <typename flt_t>
+void bit_reverse_permute(flt_t* re, flt_t* im, cmplx_size_t<flt_t> len) {
+    if (len < 2) {
+        return;
+    }
+
+    const cmplx_size_t<flt_t> numBits = bn_bit_width(len) - 1;
+
+    // Each pair of indices is swapped by the chunk holding the smaller one.
+    fft_parallel_chunks(fft_num_tasks(len), len, 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        if (!first) {
+            first = 1;
+        }
+
+        // bit-reversed value of the previous index
+        cmplx_size_t<flt_t> j = 0;
+
+        for (cmplx_size_t<flt_t> b = 0, prev = first-1; b < numBits; ++b, prev >>= 1) {
+            j = (j << 1) | (prev & 1);
+        }
+
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            cmplx_size_t<flt_t> bit = len >> 1;
+
+            for (; j & bit; bit >>= 1) {
+                j ^= bit;
+            }
+
+            j ^= bit;
+
+            if (i < j) {
+                std::swap(re[i], re[j]);
+                std::swap(im[i], im[j]);
+            }
+        }
+    });
+}
+
+
+
+template <typename flt_t>
+void bit_reverse_permute(cmplx_list_t<flt_t>& x) {
+    bit_reverse_permute<flt_t>(x.re.data(), x.im.data(), x.size());
+}
+
+
+
+/*
+ * Scratch space for the permutations of a transform, which is kept between
+ * calls on each thread. Touching freshly-allocated pages costs several times
+ * more than the permutations themselves.
+ */
+template <typename flt_t>
+cmplx_list_t<flt_t>& fft_scratch_storage() {
+    static thread_local cmplx_list_t<flt_t> scratch;
+    return scratch;
+}
+
+
+
+template <typename flt_t>
+cmplx_list_t<flt_t>& fft_scratch(cmplx_size_t<flt_t> len) {
+    cmplx_list_t<flt_t>& scratch = fft_scratch_storage<flt_t>();
+
+    if (scratch.size() < len) {
+        scratch.resize(len);
+    }
+
+    return scratch;
+}
+
+
+
+template <typename flt_t>
+void fft_clear_scratch() {
+    // assigned, rather than cleared, so the memory is actually freed
+    fft_scratch_storage<flt_t>() = cmplx_list_t<flt_t>{};
+}
+
+
+
+/*
+ * Split a signal of length (radix*blockLen) into radix interleaved
+ * sub-sequences, each stored contiguously. This is the input permutation
+ * required by the mixed-radix transform.
+ */
+template <typename flt_t>
+void fft_gather_blocks(cmplx_list_t<flt_t>& x, cmplx_size_t<flt_t> radix) {
+    const cmplx_size_t<flt_t> len = x.size();
+    const cmplx_size_t<flt_t> blockLen = len / radix;
+
+    // The signal is permuted back into its own storage, so callers may keep
+    // pointers to it across a transform.
+    cmplx_list_t<flt_t>& input = fft_scratch<flt_t>(len);
+    const cmplx_size_t<flt_t> numTasks = fft_num_tasks(len);
+
+    flt_t* const re = x.re.data();
+    flt_t* const im = x.im.data();
+    flt_t* const inRe = input.re.data();
+    flt_t* const inIm = input.im.data();
+
+    fft_parallel_chunks(numTasks, len, 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        std::copy(re + first, re + last, inRe + first);
+        std::copy(im + first, im + last, inIm + first);
+    });
+
+    fft_parallel_chunks(numTasks, blockLen, 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            for (cmplx_size_t<flt_t> r = 0; r < radix; ++r) {
+                re[r*blockLen + i] = inRe[i*radix + r];
+                im[r*blockLen + i] = inIm[i*radix + r];
+            }
+        }
+    });
+}
+
+
+
+/*
+ * Transpose a matrix of complex values, stored as separate real and
+ * imaginary arrays, in tiles small enough to stay in cache.
+ */
+template <typename flt_t>
+void fft_transpose(
+    const flt_t* srcRe, const flt_t* srcIm,
+    flt_t* dstRe, flt_t* dstIm,
+    cmplx_size_t<flt_t> rows, cmplx_size_t<flt_t> cols
+) {
+    constexpr cmplx_size_t<flt_t> tile = 32;
+
+    fft_parallel_chunks(fft_num_tasks(rows*cols), rows, tile, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> r0 = first; r0 < last; r0 += tile) {
+            const cmplx_size_t<flt_t> rEnd = (r0 + tile < last) ? r0 + tile : last;
+
+            for (cmplx_size_t<flt_t> c0 = 0; c0 < cols; c0 += tile) {
+                const cmplx_size_t<flt_t> cEnd = (c0 + tile < cols) ? c0 + tile : cols;
+
+                for (cmplx_size_t<flt_t> r = r0; r < rEnd; ++r) {
+                    for (cmplx_size_t<flt_t> c = c0; c < cEnd; ++c) {
+                        dstRe[c*rows + r] = srcRe[r*cols + c];
+                        dstIm[c*rows + r] = srcIm[r*cols + c];
+                    }
+                }
+            }
+        }
+    });
+}
+
+
+
+/*
+ * The twiddle factors of the first two passes of a radix-2 transform are 1
+ * and -i, so they are merged into a single radix-4 pass without any
+ * multiplications.
+ */
+template <typename flt_t>
+void fft_radix4_first_pass(flt_t* re, flt_t* im, cmplx_size_t<flt_t> len) {
+    for (cmplx_size_t<flt_t> i = 0; i < len; i += 4) {
+        const flt_t aRe = re[i] + re[i+1];
+        const flt_t aIm = im[i] + im[i+1];
+        const flt_t bRe = re[i] - re[i+1];
+        const flt_t bIm = im[i] - im[i+1];
+        const flt_t cRe = re[i+2] + re[i+3];
+        const flt_t cIm = im[i+2] + im[i+3];
+        const flt_t dRe = re[i+2] - re[i+3];
+        const flt_t dIm = im[i+2] - im[i+3];
+
+        re[i] = aRe + cRe;
+        im[i] = aIm + cIm;
+        re[i+2] = aRe - cRe;
+        im[i+2] = aIm - cIm;
+        re[i+1] = bRe + dIm;
+        im[i+1] = bIm - dRe;
+        re[i+3] = bRe - dIm;
+        im[i+3] = bIm + dRe;
+    }
+}
+
+
+
+/*
+ * In-place radix-2 transform of a contiguous block with a length which is a
+ * power of 2. The factors of each pass are read from a table returned by
+ * fft_roots() for any length which is a multiple of 2*len.
+ */
+template <typename flt_t>
+void fft_radix2(flt_t* re, flt_t* im, cmplx_size_t<flt_t> len, const cmplx_list_t<flt_t>& roots) {
+    // Passes with a span below this many values are run one cache-sized
+    // block at a time, so only the remaining passes stream the whole signal
+    // from memory.
+    static constexpr cmplx_size_t<flt_t> maxBlockLen = 16384;
+    static constexpr cmplx_size_t<flt_t> minBlockLen = 1024;
+
+    const cmplx_size_t<flt_t> numTasks = fft_num_tasks(len);
+    cmplx_size_t<flt_t> blockLen = (len > maxBlockLen) ? maxBlockLen : len;
+
+    // Smaller blocks keep every thread busy until the whole-signal passes.
+    while (blockLen > minBlockLen && len / blockLen < numTasks) {
+        blockLen >>= 1;
+    }
+
+    bit_reverse_permute<flt_t>(re, im, len);
+
+    fft_parallel_chunks(numTasks, len, blockLen, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; i += blockLen) {
+            cmplx_size_t<flt_t> span = 1;
+
+            if (blockLen >= 4) {
+                fft_radix4_first_pass<flt_t>(re + i, im + i, blockLen);
+                span = 4;
+            }
+
+            for (; span < blockLen; span <<= 1) {
+                fft_butterflies(
+                    re + i, im + i,
+                    roots.re.data() + span-1, roots.im.data() + span-1,
+                    blockLen, span
+                );
+            }
+        }
+    });
+
+    // Combine the even and odd partitions of each remaining span, bottom-up.
+    // Once there are fewer blocks than tasks, each task takes a strip of
+    // columns from every block instead.
+    for (cmplx_size_t<flt_t> span = blockLen; span < len; span <<= 1) {
+        const flt_t* const wRe = roots.re.data() + span-1;
+        const flt_t* const wIm = roots.im.data() + span-1;
+
+        if (len / (span << 1) >= numTasks) {
+            fft_parallel_chunks(numTasks, len, span << 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+                fft_butterflies(re + first, im + first, wRe, wIm, last - first, span);
+            });
+        }
+        else {
+            fft_parallel_chunks(numTasks, span, 16, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+                fft_butterflies(re + first, im + first, wRe + first, wIm + first, len, span, last - first);
+            });
+        }
+    }
+}
+
+
+
+/*
+ * Four-step (Bailey) transform of a contiguous block with a length which is
+ * a power of 2. The block is treated as a matrix of (rows*cols) values so
+ * every sub-transform fits in cache:
+ *     1. Transform each column, after transposing them into rows.
+ *     2. Scale element (k1, q) by exp(-2*pi*i*q*k1/len).
+ *     3. Transform each row, after transposing back.
+ *     4. Transpose once more to return the output to its natural order.
+ */
+template <typename flt_t>
+void fft_four_step(flt_t* re, flt_t* im, cmplx_size_t<flt_t> len) {
+    static constexpr double pi = 3.1415926535897932384626433832795;
+
+    // cols is the smaller dimension when len is an odd power of 2
+    cmplx_size_t<flt_t> rowBits = 0;
+
+    while ((cmplx_size_t<flt_t>{1} << (2 * (rowBits+1))) <= len) {
+        ++rowBits;
+    }
+
+    const cmplx_size_t<flt_t> cols = cmplx_size_t<flt_t>{1} << rowBits;
+    const cmplx_size_t<flt_t> rows = len / cols;
+    const cmplx_size_t<flt_t> rowShift = bn_bit_width(rows) - 1;
+    const cmplx_size_t<flt_t> numTasks = fft_num_tasks(len);
+
+    const cmplx_table_t<flt_t> rowRoots = fft_roots<flt_t>(rows);
+    const cmplx_table_t<flt_t> colRoots = fft_roots<flt_t>(cols);
+
+    cmplx_list_t<flt_t>& scratch = fft_scratch<flt_t>(len);
+    flt_t* const tRe = scratch.re.data();
+    flt_t* const tIm = scratch.im.data();
+
+    // Each twiddle factor exp(-2*pi*i*j/len) is split into the product of
+    // two factors from much smaller tables, using j = jHigh*rows + jLow.
+    cmplx_list_t<flt_t> lowRoots;
+    cmplx_list_t<flt_t> highRoots;
+    lowRoots.resize(rows);
+    highRoots.resize(cols);
+
+    for (cmplx_size_t<flt_t> j = 0; j < rows; ++j) {
+        const double w = -2.0 * pi * (double)j / (double)len;
+        lowRoots.re[j] = (flt_t)std::cos(w);
+        lowRoots.im[j] = (flt_t)std::sin(w);
+    }
+
+    for (cmplx_size_t<flt_t> j = 0; j < cols; ++j) {
+        const double w = -2.0 * pi * (double)j / (double)cols;
+        highRoots.re[j] = (flt_t)std::cos(w);
+        highRoots.im[j] = (flt_t)std::sin(w);
+    }
+
+    // 1. columns of the (rows x cols) input become rows of the scratch
+    fft_transpose<flt_t>(re, im, tRe, tIm, rows, cols);
+
+    fft_parallel_chunks(numTasks, cols, 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> q = first; q < last; ++q) {
+            flt_t* const rowRe = tRe + q*rows;
+            flt_t* const rowIm = tIm + q*rows;
+
+            fft_radix2<flt_t>(rowRe, rowIm, rows, *rowRoots);
+
+            // 2. twiddle factors, with q*k1 < len
+            for (cmplx_size_t<flt_t> k = 1; k < rows; ++k) {
+                const cmplx_size_t<flt_t> j = q * k;
+                const cmplx_size_t<flt_t> lo = j & (rows-1);
+                const cmplx_size_t<flt_t> hi = j >> rowShift;
+
+                const flt_t wRe = lowRoots.re[lo]*highRoots.re[hi] - lowRoots.im[lo]*highRoots.im[hi];
+                const flt_t wIm = lowRoots.re[lo]*highRoots.im[hi] + lowRoots.im[lo]*highRoots.re[hi];
+
+                const flt_t xRe = rowRe[k];
+                const flt_t xIm = rowIm[k];
+
+                rowRe[k] = xRe*wRe - xIm*wIm;
+                rowIm[k] = xRe*wIm + xIm*wRe;
+            }
+        }
+    });
+
+    // 3. rows of length cols, indexed by k1
+    fft_transpose<flt_t>(tRe, tIm, re, im, cols, rows);
+
+    fft_parallel_chunks(numTasks, rows, 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> k = first; k < last; ++k) {
+            fft_radix2<flt_t>(re + k*cols, im + k*cols, cols, *colRoots);
+        }
+    });
+
+    // 4. element (k1, k2) holds output (k1 + rows*k2)
+    fft_transpose<flt_t>(re, im, tRe, tIm, rows, cols);
+
+    fft_parallel_chunks(numTasks, len, 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        std::copy(tRe + first, tRe + last, re + first);
+        std::copy(tIm + first, tIm + last, im + first);
+    });
+}
+
+
+
+/*
+ * Final pass of a mixed-radix transform. Element k of every block is scaled
+ * by its twiddle factor, then the blocks are combined with a DFT of length 3.
+ * Only the first "count" elements of each block are processed, so a pass can
+ * be split into strips by offsetting re, im, wRe, and wIm.
+ */
+template <typename flt_t>
+void fft_radix3_pass(flt_t* re, flt_t* im, const flt_t* wRe, const flt_t* wIm, cmplx_size_t<flt_t> blockLen, cmplx_size_t<flt_t> count) {
+    // sin(2*pi/3)
+    constexpr flt_t s1 = flt_t{0.86602540378443864676};
+    constexpr flt_t half = flt_t{0.5};
+
+    const flt_t* const w1Re = wRe;
+    const flt_t* const w1Im = wIm;
+    const flt_t* const w2Re = wRe + blockLen;
+    const flt_t* const w2Im = wIm + blockLen;
+
+    flt_t* const re1 = re + blockLen;
+    flt_t* const im1 = im + blockLen;
+    flt_t* const re2 = re + 2*blockLen;
+    flt_t* const im2 = im + 2*blockLen;
+
+    for (cmplx_size_t<flt_t> k = 0; k < count; ++k) {
+        const flt_t aRe = re1[k]*w1Re[k] - im1[k]*w1Im[k];
+        const flt_t aIm = re1[k]*w1Im[k] + im1[k]*w1Re[k];
+        const flt_t bRe = re2[k]*w2Re[k] - im2[k]*w2Im[k];
+        const flt_t bIm = re2[k]*w2Im[k] + im2[k]*w2Re[k];
+
+        const flt_t sumRe = aRe + bRe;
+        const flt_t sumIm = aIm + bIm;
+        const flt_t midRe = re[k] - half*sumRe;
+        const flt_t midIm = im[k] - half*sumIm;
+
+        // -i*sin(2*pi/3)*(a-b)
+        const flt_t rotRe = s1 * (aIm - bIm);
+        const flt_t rotIm = s1 * (bRe - aRe);
+
+        re[k] += sumRe;
+        im[k] += sumIm;
+        re1[k] = midRe + rotRe;
+        im1[k] = midIm + rotIm;
+        re2[k] = midRe - rotRe;
+        im2[k] = midIm - rotIm;
+    }
+}
+
+
+
+template <typename flt_t>
+void fft_radix5_pass(flt_t* re, flt_t* im, const flt_t* wRe, const flt_t* wIm, cmplx_size_t<flt_t> blockLen, cmplx_size_t<flt_t> count) {
+    // cos(2*pi/5), cos(4*pi/5), sin(2*pi/5), sin(4*pi/5)
+    constexpr flt_t c1 = flt_t{0.30901699437494742410};
+    constexpr flt_t c2 = flt_t{-0.80901699437494742410};
+    constexpr flt_t s1 = flt_t{0.95105651629515357212};
+    constexpr flt_t s2 = flt_t{0.58778525229247312917};
+
+    flt_t* const re1 = re + blockLen;
+    flt_t* const im1 = im + blockLen;
+    flt_t* const re2 = re + 2*blockLen;
+    flt_t* const im2 = im + 2*blockLen;
+    flt_t* const re3 = re + 3*blockLen;
+    flt_t* const im3 = im + 3*blockLen;
+    flt_t* const re4 = re + 4*blockLen;
+    flt_t* const im4 = im + 4*blockLen;
+
+    for (cmplx_size_t<flt_t> k = 0; k < count; ++k) {
+        const flt_t aRe = re1[k]*wRe[k] - im1[k]*wIm[k];
+        const flt_t aIm = re1[k]*wIm[k] + im1[k]*wRe[k];
+        const flt_t bRe = re2[k]*wRe[k+blockLen] - im2[k]*wIm[k+blockLen];
+        const flt_t bIm = re2[k]*wIm[k+blockLen] + im2[k]*wRe[k+blockLen];
+        const flt_t cRe = re3[k]*wRe[k+2*blockLen] - im3[k]*wIm[k+2*blockLen];
+        const flt_t cIm = re3[k]*wIm[k+2*blockLen] + im3[k]*wRe[k+2*blockLen];
+        const flt_t dRe = re4[k]*wRe[k+3*blockLen] - im4[k]*wIm[k+3*blockLen];
+        const flt_t dIm = re4[k]*wIm[k+3*blockLen] + im4[k]*wRe[k+3*blockLen];
+
+        // pair the inputs whose factors are conjugates of each other
+        const flt_t sum14Re = aRe + dRe;
+        const flt_t sum14Im = aIm + dIm;
+        const flt_t sum23Re = bRe + cRe;
+        const flt_t sum23Im = bIm + cIm;
+        const flt_t diff14Re = aRe - dRe;
+        const flt_t diff14Im = aIm - dIm;
+        const flt_t diff23Re = bRe - cRe;
+        const flt_t diff23Im = bIm - cIm;
+
+        const flt_t mid1Re = re[k] + c1*sum14Re + c2*sum23Re;
+        const flt_t mid1Im = im[k] + c1*sum14Im + c2*sum23Im;
+        const flt_t mid2Re = re[k] + c2*sum14Re + c1*sum23Re;
+        const flt_t mid2Im = im[k] + c2*sum14Im + c1*sum23Im;
+
+        // -i*(s1*diff14 + s2*diff23) and -i*(s2*diff14 - s1*diff23)
+        const flt_t rot1Re = s1*diff14Im + s2*diff23Im;
+        const flt_t rot1Im = -(s1*diff14Re + s2*diff23Re);
+        const flt_t rot2Re = s2*diff14Im - s1*diff23Im;
+        const flt_t rot2Im = s1*diff23Re - s2*diff14Re;
+
+        re[k] += sum14Re + sum23Re;
+        im[k] += sum14Im + sum23Im;
+        re1[k] = mid1Re + rot1Re;
+        im1[k] = mid1Im + rot1Im;
+        re4[k] = mid1Re - rot1Re;
+        im4[k] = mid1Im - rot1Im;
+        re2[k] = mid2Re + rot2Re;
+        im2[k] = mid2Im + rot2Im;
+        re3[k] = mid2Re - rot2Re;
+        im3[k] = mid2Im - rot2Im;
+    }
+}
+
+
+
+/*
+ * Iterative, in-place Cooley-Tukey transform. The input list must have a
+ * length returned by fft_length(). Mixed-radix lengths run a radix-2
+ * transform on each of their interleaved sub-sequences, followed by a single
+ * radix-3 or radix-5 pass. When enabled, radix-2 transforms of at least
+ * fft_four_step_length() values use the four-step algorithm.
+ */
 template <typename flt_t>
 void fft_complex(cmplx_list_t<flt_t>& x) {
-    static constexpr flt_t pi = 3.1415926535897932384626433832795;
-    
-    // in the event that an array was passed in with a non-power-of-two length.
     const cmplx_size_t<flt_t> len = x.size();
-    
+
     // base case
-    if (len == 1) {
-        x = cmplx_list_t<flt_t>{x[0]};
+    if (len < 2) {
         return;
     }
 
-    // Partition the input list into evenly-index and oddly-indexed elements.
-    const cmplx_size_t<flt_t> halfLen = len / 2;
-    
-    cmplx_list_t<flt_t> evens;  evens.reserve(halfLen);
-    cmplx_list_t<flt_t> odds;   odds.reserve(halfLen);
+    const cmplx_size_t<flt_t> radix = fft_radix(len);
+    const cmplx_size_t<flt_t> blockLen = len / radix;
+    const cmplx_size_t<flt_t> fourStepLen = fft_four_step_length();
+    const bool fourStep = fourStepLen && blockLen >= fourStepLen && blockLen >= 4;
+
+    BN_ASSERT(radix == 1 || radix == 3 || radix == 5);
+
+    if (radix > 1) {
+        fft_gather_blocks<flt_t>(x, radix);
+    }
+
+    flt_t* const re = x.re.data();
+    flt_t* const im = x.im.data();
 
-    for (cmplx_size_t<flt_t> i = 0; i < halfLen; ++i) {
-        // zero-pad both partitions if the input array was not at the
-        // required radix=2 capacity
-        if (i < x.size()) {
-            evens.push_back(x[2*i]);
-            odds.push_back(x[2*i+1]);
+    // The full table is only needed by the radix-2 passes and the final
+    // pass of a mixed-radix transform.
+    cmplx_table_t<flt_t> rootTable;
+
+    if (radix > 1 || !fourStep) {
+        rootTable = fft_roots<flt_t>(len);
+    }
+
+    for (cmplx_size_t<flt_t> r = 0; r < radix; ++r) {
+        if (fourStep) {
+            fft_four_step<flt_t>(re + r*blockLen, im + r*blockLen, blockLen);
         }
         else {
-            evens[i] = odds[i] = std::complex<flt_t>{0};
+            fft_radix2<flt_t>(re + r*blockLen, im + r*blockLen, blockLen, *rootTable);
         }
     }
 
-    // TODO: Fix the recursion!
-    fft_complex<flt_t>(evens);
-    fft_complex<flt_t>(odds);
+    if (len > BN_FFT_SCRATCH_KEEP_LEN) {
+        fft_clear_scratch<flt_t>();
+    }
+
+    if (radix == 1) {
+        return;
+    }
+
+    const flt_t* const wRe = rootTable->re.data() + (len-1);
+    const flt_t* const wIm = rootTable->im.data() + (len-1);
+
+    fft_parallel_chunks(fft_num_tasks(len), blockLen, 16, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        if (radix == 3) {
+            fft_radix3_pass<flt_t>(re + first, im + first, wRe + first, wIm + first, blockLen, last - first);
+        }
+        else {
+            fft_radix5_pass<flt_t>(re + first, im + first, wRe + first, wIm + first, blockLen, last - first);
+        }
+    });
+}
 
-    // combine the even and odd partitions
-    const cmplx_size_t<flt_t> nf = (flt_t)len;
 
-    for (cmplx_size_t<flt_t> k = 0; k < halfLen; ++k) {
-        const flt_t kf = (flt_t)k;
-        const flt_t w = -2.0 * kf * pi / nf;
-        const std::complex<flt_t> wk {std::cos(w), std::sin(w)};
 
-        x[k] = evens[k] + (wk * odds[k]);
-        x[k+halfLen] = evens[k] - (wk * odds[k]);
+template <typename flt_t>
+void fft_butterflies_scalar(
+    flt_t* re, flt_t* im,
+    const flt_t* wRe, const flt_t* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        flt_t* const evenRe = re + i;
+        flt_t* const evenIm = im + i;
+        flt_t* const oddRe = re + i + span;
+        flt_t* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; ++k) {
+            const flt_t tRe = oddRe[k]*wRe[k] - oddIm[k]*wIm[k];
+            const flt_t tIm = oddRe[k]*wIm[k] + oddIm[k]*wRe[k];
+
+            oddRe[k] = evenRe[k] - tRe;
+            oddIm[k] = evenIm[k] - tIm;
+            evenRe[k] += tRe;
+            evenIm[k] += tIm;
+        }
     }
 }
 
@@ -89,53 +753,113 @@ void fft_complex(cmplx_list_t<flt_t>& x) {
 
 template <typename flt_t>
 void ifft_complex(cmplx_list_t<flt_t>& x) {
-    for (cmplx_value_t<flt_t>& e : x) {
-        e = std::conj(e);
-    }
+    flt_t* const conjIm = x.im.data();
+
+    fft_parallel_chunks(fft_num_tasks(x.size()), x.size(), 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            conjIm[i] = -conjIm[i];
+        }
+    });
 
     fft_complex<flt_t>(x);
 
-    const flt_t len = static_cast<flt_t>(x.size());
+    const flt_t scale = flt_t{1} / static_cast<flt_t>(x.size());
+
+    flt_t* const re = x.re.data();
+    flt_t* const im = x.im.data();
+
+    fft_parallel_chunks(fft_num_tasks(x.size()), x.size(), 1, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            re[i] *= scale;
+            im[i] *= -scale;
+        }
+    });
+}
+
+
+
+template <typename flt_t>
+bool fft_is_exact(bn_u64_t maxDigit, cmplx_size_t<flt_t> aLen, cmplx_size_t<flt_t> bLen) {
+    const cmplx_size_t<flt_t> minLen = aLen < bLen ? aLen : bLen;
+    const cmplx_size_t<flt_t> fftLen = fft_length<flt_t>(aLen + bLen);
+
+    const bn_u64_t numBits = 2 * bn_bit_width(maxDigit)
+        + bn_bit_width(minLen)
+        + bn_bit_width(bn_bit_width(fftLen))
+        + 2;
+
+    return numBits <= (bn_u64_t)std::numeric_limits<flt_t>::digits;
+}
+
+
 
-    for (cmplx_value_t<flt_t>& e : x) {
-        e = std::conj(e) / len;
+template <typename flt_t>
+unsigned fft_num_pieces(bn_u64_t maxDigit, cmplx_size_t<flt_t> aLen, cmplx_size_t<flt_t> bLen) {
+    if (fft_is_exact<flt_t>(maxDigit, aLen, bLen)) {
+        return 1;
     }
+
+    // only digits which are made of whole bits can be split into bit fields
+    if (!isPow2(maxDigit + 1)) {
+        return 0;
+    }
+
+    const unsigned digitBits = (unsigned)bn_bit_width(maxDigit);
+
+    for (unsigned numPieces = 2; digitBits / numPieces >= 8 && !(digitBits % numPieces); numPieces <<= 1) {
+        const bn_u64_t pieceMax = (bn_u64_t{1} << (digitBits / numPieces)) - 1;
+
+        if (fft_is_exact<flt_t>(pieceMax, aLen * numPieces, bLen * numPieces)) {
+            return numPieces;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/*
+ * Retrieve one field of a digit which has been split into bit fields.
+ */
+template <typename digit_t>
+inline bn_u64_t fft_digit_piece(const digit_t& digit, unsigned piece, unsigned numPieces, unsigned pieceBits) {
+    if (numPieces == 1) {
+        return (bn_u64_t)digit;
+    }
+
+    return ((bn_u64_t)digit >> (piece * pieceBits)) & ((bn_u64_t{1} << pieceBits) - 1);
 }
 
 
 
 template <typename container_t, typename flt_t>
-cmplx_list_t<flt_t> create_fft_table(const container_t& a, const container_t& b) {
+cmplx_list_t<flt_t> create_fft_table(
+    const container_t& a,
+    const container_t& b,
+    unsigned numPieces,
+    unsigned pieceBits
+) {
     typedef typename container_t::size_type big_size_type;
-    typedef typename container_t::value_type big_value_type;
     
     // Create a list of complex numbers with interleaved values from the two
     // input numbers. The output list must have a length that's a power of 2.
-    big_size_type aLen = a.size();
-    big_size_type bLen = b.size();
-    
-    // Ensure the Cooley-Tukey algorithm has its radix=2 requirement fulfilled.
-    // Add a few digits to the end so the algorithm has room for overflow.
-    big_size_type size = aLen + bLen;
+    const big_size_type aLen = a.size() * numPieces;
+    const big_size_type bLen = b.size() * numPieces;
     
-    if (!isPow2(size)) {
-        size = nextPow2(size);
-    }
+    // Pad the product to a length supported by the transform.
+    const big_size_type size = fft_length<flt_t>(aLen + bLen);
     
+    // Digits past the end of either operand are left as zero-padding.
     cmplx_list_t<flt_t> ret;
-    ret.reserve(size);
+    ret.resize(size);
     
-    for (big_size_type i = 0; i < size; ++i) {
-        // Add some zero-padding to the output list if necessary
-        big_value_type aVal = 0;
-        
-        if (i < aLen) { aVal = a[i]; }
-        
-        big_value_type bVal = 0;
-        
-        if (i < bLen) { bVal = b[i]; }
-        
-        ret.push_back(std::complex<flt_t>{(flt_t)aVal, (flt_t)bVal});
+    for (big_size_type i = 0; i < aLen; ++i) {
+        ret.re[i] = (flt_t)fft_digit_piece(a[i / numPieces], i % numPieces, numPieces, pieceBits);
+    }
+    
+    for (big_size_type i = 0; i < bLen; ++i) {
+        ret.im[i] = (flt_t)fft_digit_piece(b[i / numPieces], i % numPieces, numPieces, pieceBits);
     }
     
     return ret;
@@ -146,25 +870,262 @@ cmplx_list_t<flt_t> create_fft_table(const container_t& a, const container_t& b)
 template <typename flt_t>
 void convolute_fft(cmplx_list_t<flt_t>& fftTable) {
     const cmplx_size_t<flt_t> fftSize = fftTable.size();
-    
-	// transform.
-    cmplx_list_t<flt_t> transforms{fftTable};
-    fft_complex<flt_t>(transforms);
-
-    // point-wise multiplication in frequency domain.
-    for (cmplx_size_t<flt_t> i = 0; i < fftSize; ++i) {
-        // extract the individual transformed signals from the composed one.
-        const cmplx_value_t<flt_t>& ti = transforms[i];
-        const cmplx_value_t<flt_t>&& tc = std::conj(transforms[-i % fftSize]);
-        
-        // perform convolution
-        const cmplx_value_t<flt_t> x1 = ti + tc;
-        const cmplx_value_t<flt_t> x2 = ti - tc;
-        const cmplx_value_t<flt_t> x3 = x1 * x2;
-
-        // avoid pedantic compilers
-        constexpr flt_t rotation = flt_t{0.25};
-        
-        fftTable[i] = std::complex<flt_t>{x3.imag(), -x3.real()} * rotation;
+
+    if (!fftSize) {
+        return;
+    }
+
+    // avoid pedantic compilers
+    constexpr flt_t rotation = flt_t{0.25};
+
+    flt_t* const re = fftTable.re.data();
+    flt_t* const im = fftTable.im.data();
+
+    // transform.
+    fft_complex<flt_t>(fftTable);
+
+    // Extract the individual transformed signals from the composed one and
+    // perform point-wise multiplication in the frequency domain. Each element
+    // depends on its mirror at (fftSize-i), so both are updated together
+    // in-place. With x1 = t[i] + conj(t[j]) and x2 = t[i] - conj(t[j]), the
+    // product at i is -i*x1*x2/4 and the product at j is its conjugate.
+    fft_parallel_chunks(fft_num_tasks(fftSize), fftSize/2 + 1, 16, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            const cmplx_size_t<flt_t> j = (fftSize - i) % fftSize;
+
+            const flt_t sumRe = re[i] + re[j];
+            const flt_t sumIm = im[i] - im[j];
+            const flt_t diffRe = re[i] - re[j];
+            const flt_t diffIm = im[i] + im[j];
+
+            const flt_t prodRe = (sumRe*diffRe - sumIm*diffIm) * rotation;
+            const flt_t prodIm = (sumRe*diffIm + sumIm*diffRe) * rotation;
+
+            re[i] = prodIm;
+            im[i] = -prodRe;
+            re[j] = prodIm;
+            im[j] = prodRe;
+        }
+    });
+}
+
+
+
+template <typename container_t, typename flt_t>
+cmplx_list_t<flt_t> create_fft_sqr_table(
+    const container_t& a,
+    unsigned numPieces,
+    unsigned pieceBits
+) {
+    // The full (real-valued) transform has the same length as the one for a
+    // general product, but is packed into half as many complex values.
+    const cmplx_size_t<flt_t> size = fft_real_length<flt_t>(a.size() * numPieces * 2);
+
+    return create_fft_real_table<container_t, flt_t>(a, size, numPieces, pieceBits);
+}
+
+
+
+template <typename flt_t>
+void convolute_fft_sqr(cmplx_list_t<flt_t>& fftTable) {
+    const cmplx_size_t<flt_t> fftSize = fftTable.size();
+
+    if (!fftSize) {
+        return;
     }
+
+    constexpr flt_t half = flt_t{0.5};
+
+    flt_t* const re = fftTable.re.data();
+    flt_t* const im = fftTable.im.data();
+
+    // Twiddle factors of the full-length real transform, which are stored
+    // after those of every shorter pass.
+    const cmplx_table_t<flt_t> rootTable = fft_roots<flt_t>(fftSize * 2);
+    const flt_t* const wRe = rootTable->re.data() + (fftSize - 1);
+    const flt_t* const wIm = rootTable->im.data() + (fftSize - 1);
+
+    fft_complex<flt_t>(fftTable);
+
+    // The spectra of the even and odd digits at k are recovered from the
+    // packed spectrum at k and its mirror:
+    //     E = (z[k] + conj(z[j]))/2, D = (z[k] - conj(z[j]))/2i
+    // The full-length spectrum is E + w*D at k and E - w*D at k+fftSize.
+    // Squaring both and packing them again gives
+    //     Y[k] = E^2 + w^2*D^2 + 2i*E*D
+    // while the mirror uses conj(E) and conj(D) with its own twiddle factor.
+    fft_parallel_chunks(fft_num_tasks(fftSize), fftSize/2 + 1, 16, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            const cmplx_size_t<flt_t> j = (fftSize - i) % fftSize;
+
+            const flt_t eRe = (re[i] + re[j]) * half;
+            const flt_t eIm = (im[i] - im[j]) * half;
+            const flt_t dRe = (im[i] + im[j]) * half;
+            const flt_t dIm = (re[j] - re[i]) * half;
+
+            const flt_t e2Re = eRe*eRe - eIm*eIm;
+            const flt_t e2Im = 2*eRe*eIm;
+            const flt_t d2Re = dRe*dRe - dIm*dIm;
+            const flt_t d2Im = 2*dRe*dIm;
+            const flt_t edRe = eRe*dRe - eIm*dIm;
+            const flt_t edIm = eRe*dIm + eIm*dRe;
+
+            const flt_t wiRe = wRe[i]*wRe[i] - wIm[i]*wIm[i];
+            const flt_t wiIm = 2*wRe[i]*wIm[i];
+            const flt_t wjRe = wRe[j]*wRe[j] - wIm[j]*wIm[j];
+            const flt_t wjIm = 2*wRe[j]*wIm[j];
+
+            re[i] = e2Re + (wiRe*d2Re - wiIm*d2Im) - 2*edIm;
+            im[i] = e2Im + (wiRe*d2Im + wiIm*d2Re) + 2*edRe;
+            re[j] = e2Re + (wjRe*d2Re + wjIm*d2Im) + 2*edIm;
+            im[j] = -e2Im + (wjIm*d2Re - wjRe*d2Im) + 2*edRe;
+        }
+    });
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Precomputed transforms of real-valued signals
+///////////////////////////////////////////////////////////////////////////////
+template <typename flt_t>
+cmplx_size_t<flt_t> fft_real_length(cmplx_size_t<flt_t> productLen) {
+    if (productLen < 2) {
+        return 1;
+    }
+
+    return fft_length<flt_t>(productLen) / 2;
+}
+
+
+
+template <typename container_t, typename flt_t>
+cmplx_list_t<flt_t> create_fft_real_table(
+    const container_t& a,
+    cmplx_size_t<flt_t> fftSize,
+    unsigned numPieces,
+    unsigned pieceBits
+) {
+    typedef typename container_t::size_type big_size_type;
+
+    const big_size_type aLen = a.size() * numPieces;
+
+    BN_ASSERT(fft_length<flt_t>(fftSize * 2) == fftSize * 2);
+    BN_ASSERT(aLen <= fftSize * 2);
+
+    cmplx_list_t<flt_t> ret;
+    ret.resize(fftSize);
+
+    for (big_size_type i = 0; i < aLen; ++i) {
+        const flt_t piece = (flt_t)fft_digit_piece(a[i / numPieces], i % numPieces, numPieces, pieceBits);
+
+        if (i & 1) {
+            ret.im[i/2] = piece;
+        }
+        else {
+            ret.re[i/2] = piece;
+        }
+    }
+
+    return ret;
+}
+
+
+
+template <typename flt_t>
+BNRealSpectrum<flt_t> fft_real_spectrum(cmplx_list_t<flt_t>& fftTable) {
+    const cmplx_size_t<flt_t> fftSize = fftTable.size();
+
+    BNRealSpectrum<flt_t> ret;
+    ret.fftSize = fftSize;
+
+    if (!fftSize) {
+        return ret;
+    }
+
+    constexpr flt_t half = flt_t{0.5};
+
+    fft_complex<flt_t>(fftTable);
+
+    const flt_t* const re = fftTable.re.data();
+    const flt_t* const im = fftTable.im.data();
+
+    ret.even.resize(fftSize / 2 + 1);
+    ret.odd.resize(fftSize / 2 + 1);
+
+    // Same unpacking as convolute_fft_sqr():
+    //     E = (z[k] + conj(z[j]))/2, D = (z[k] - conj(z[j]))/2i
+    fft_parallel_chunks(fft_num_tasks(fftSize), fftSize/2 + 1, 16, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            const cmplx_size_t<flt_t> j = (fftSize - i) % fftSize;
+
+            ret.even.re[i] = (re[i] + re[j]) * half;
+            ret.even.im[i] = (im[i] - im[j]) * half;
+            ret.odd.re[i] = (im[i] + im[j]) * half;
+            ret.odd.im[i] = (re[j] - re[i]) * half;
+        }
+    });
+
+    return ret;
+}
+
+
+
+template <typename flt_t>
+void convolute_fft_spectrum(cmplx_list_t<flt_t>& fftTable, const BNRealSpectrum<flt_t>& spectrum) {
+    const cmplx_size_t<flt_t> fftSize = fftTable.size();
+
+    BN_ASSERT(fftSize == spectrum.fftSize);
+
+    if (!fftSize) {
+        return;
+    }
+
+    constexpr flt_t half = flt_t{0.5};
+
+    flt_t* const re = fftTable.re.data();
+    flt_t* const im = fftTable.im.data();
+
+    const cmplx_table_t<flt_t> rootTable = fft_roots<flt_t>(fftSize * 2);
+    const flt_t* const wRe = rootTable->re.data() + (fftSize - 1);
+    const flt_t* const wIm = rootTable->im.data() + (fftSize - 1);
+
+    const flt_t* const ebRe = spectrum.even.re.data();
+    const flt_t* const ebIm = spectrum.even.im.data();
+    const flt_t* const dbRe = spectrum.odd.re.data();
+    const flt_t* const dbIm = spectrum.odd.im.data();
+
+    fft_complex<flt_t>(fftTable);
+
+    // With the even and odd spectra of both operands, the product packs as
+    //     Y[k] = Ea*Eb + w^2*Da*Db + i*(Ea*Db + Da*Eb)
+    // while the mirror uses the conjugate of each term with its own twiddle
+    // factor, as in convolute_fft_sqr().
+    fft_parallel_chunks(fft_num_tasks(fftSize), fftSize/2 + 1, 16, [&](cmplx_size_t<flt_t> first, cmplx_size_t<flt_t> last) {
+        for (cmplx_size_t<flt_t> i = first; i < last; ++i) {
+            const cmplx_size_t<flt_t> j = (fftSize - i) % fftSize;
+
+            const flt_t eRe = (re[i] + re[j]) * half;
+            const flt_t eIm = (im[i] - im[j]) * half;
+            const flt_t dRe = (im[i] + im[j]) * half;
+            const flt_t dIm = (re[j] - re[i]) * half;
+
+            const flt_t pRe = eRe*ebRe[i] - eIm*ebIm[i];
+            const flt_t pIm = eRe*ebIm[i] + eIm*ebRe[i];
+            const flt_t qRe = dRe*dbRe[i] - dIm*dbIm[i];
+            const flt_t qIm = dRe*dbIm[i] + dIm*dbRe[i];
+            const flt_t rRe = (eRe*dbRe[i] - eIm*dbIm[i]) + (dRe*ebRe[i] - dIm*ebIm[i]);
+            const flt_t rIm = (eRe*dbIm[i] + eIm*dbRe[i]) + (dRe*ebIm[i] + dIm*ebRe[i]);
+
+            const flt_t wiRe = wRe[i]*wRe[i] - wIm[i]*wIm[i];
+            const flt_t wiIm = 2*wRe[i]*wIm[i];
+            const flt_t wjRe = wRe[j]*wRe[j] - wIm[j]*wIm[j];
+            const flt_t wjIm = 2*wRe[j]*wIm[j];
+
+            re[i] = pRe + (wiRe*qRe - wiIm*qIm) - rIm;
+            im[i] = pIm + (wiRe*qIm + wiIm*qRe) + rRe;
+            re[j] = pRe + (wjRe*qRe + wjIm*qIm) + rIm;
+            im[j] = -pIm + (wjIm*qRe - wjRe*qIm) + rRe;
+        }
+    });
 }
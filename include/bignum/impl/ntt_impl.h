@@ -0,0 +1,137 @@
+/* 
+ * File:   ntt_impl.h
+ */
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Residue table creation
+///////////////////////////////////////////////////////////////////////////////
+template <typename container_t>
+ntt_list_t create_ntt_table(const container_t& a, ntt_size_t len, unsigned prime) {
+    const bn_u64_t modulus = BN_NTT_PRIMES[prime].modulus;
+    const ntt_size_t aLen = a.size() < len ? a.size() : len;
+
+    ntt_list_t ret(len, 0);
+
+    for (ntt_size_t i = 0; i < aLen; ++i) {
+        ret[i] = (BN_UINT32)((bn_u64_t)a[i] % modulus);
+    }
+
+    return ret;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// CRT reconstruction and carry propagation
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t, typename container_t>
+container_t ntt_crt_carry(const ntt_list_t* residues, unsigned numPrimes, ntt_size_t count) {
+    typedef typename limits_t::base_single bn_single;
+    typedef typename container_t::size_type big_size_type;
+
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+    static constexpr bn_u64_t WORD_MASK = 0xFFFFFFFF;
+
+    static constexpr bn_u64_t p0 = BN_NTT_PRIMES[0].modulus;
+    static constexpr bn_u64_t p1 = BN_NTT_PRIMES[1].modulus;
+    static constexpr bn_u64_t p2 = BN_NTT_PRIMES[2].modulus;
+    static constexpr bn_u64_t p01 = p0 * p1;
+
+    // Garner's constants: p0^-1 (mod p1) and (p0*p1)^-1 (mod p2)
+    static const bn_u64_t inv0 = ntt_pow_mod(p0 % p1, p1-2, p1);
+    static const bn_u64_t inv01 = ntt_pow_mod(p01 % p2, p2-2, p2);
+
+    container_t ret;
+
+    if (numPrimes < 3) {
+        // Every output is less than p0*p1 < 2^60, so the running carry fits
+        // in a single 64-bit word.
+        bn_u64_t carry = 0;
+
+        for (ntt_size_t i = 0; i < count; ++i) {
+            const bn_u64_t r0 = residues[0][i];
+            bn_u64_t x = r0;
+
+            if (numPrimes > 1) {
+                const bn_u64_t v1 = ((residues[1][i] + p1 - r0 % p1) % p1) * inv0 % p1;
+                x += p0 * v1;
+            }
+
+            carry += x;
+            ret.push_back((bn_single)(carry % NUM_BASE));
+            carry /= NUM_BASE;
+        }
+
+        while (carry) {
+            ret.push_back((bn_single)(carry % NUM_BASE));
+            carry /= NUM_BASE;
+        }
+    }
+    else {
+        // Outputs may reach 2^87. The running carry is held in three 32-bit
+        // words, from least to most significant.
+        bn_u64_t c0 = 0;
+        bn_u64_t c1 = 0;
+        bn_u64_t c2 = 0;
+
+        const auto add_at = [&c0, &c1, &c2](bn_u64_t val, bool shifted)->void {
+            if (!shifted) {
+                const bn_u64_t lo = c0 + (val & WORD_MASK);
+                c0 = lo & WORD_MASK;
+                val = (val >> 32) + (lo >> 32);
+            }
+
+            const bn_u64_t mid = c1 + (val & WORD_MASK);
+            c1 = mid & WORD_MASK;
+            c2 += (val >> 32) + (mid >> 32);
+        };
+
+        const auto div_base = [&c0, &c1, &c2]()->bn_u64_t {
+            bn_u64_t rem = 0;
+            bn_u64_t* const words[3] = {&c2, &c1, &c0};
+
+            for (bn_u64_t* w : words) {
+                const bn_u64_t cur = (rem << 32) | *w;
+                *w = cur / NUM_BASE;
+                rem = cur % NUM_BASE;
+            }
+
+            return rem;
+        };
+
+        for (ntt_size_t i = 0; i < count; ++i) {
+            const bn_u64_t r0 = residues[0][i];
+            const bn_u64_t v1 = ((residues[1][i] + p1 - r0 % p1) % p1) * inv0 % p1;
+            const bn_u64_t x01 = r0 + p0 * v1;
+            const bn_u64_t v2 = ((residues[2][i] + p2 - x01 % p2) % p2) * inv01 % p2;
+
+            // x = x01 + (p0*p1)*v2
+            add_at(x01, false);
+            add_at((p01 & WORD_MASK) * v2, false);
+            add_at((p01 >> 32) * v2, true);
+
+            ret.push_back((bn_single)div_base());
+        }
+
+        while (c0 || c1 || c2) {
+            ret.push_back((bn_single)div_base());
+        }
+    }
+
+    // trim leading zeroes from the most-significant digits
+    big_size_type numZeroes = 0;
+
+    for (big_size_type i = ret.size(); i --> 0;) {
+        if (ret[i]) {
+            break;
+        }
+
+        ++numZeroes;
+    }
+
+    ret.resize(ret.size() - numZeroes);
+
+    return ret;
+}
@@ -0,0 +1,143 @@
+/* 
+ * File:   ntt.h
+ */
+
+#ifndef __BN_NTT_H__
+#define	__BN_NTT_H__
+
+#include <vector>
+
+#include "bignum/bn_setup.h"
+#include "bignum/bn_limits.h"
+
+
+
+typedef std::vector<BN_UINT32> ntt_list_t;
+
+typedef ntt_list_t::size_type ntt_size_t;
+
+
+
+/**
+ * Word-sized prime used by the number-theoretic transform. Every prime has
+ * the form (c*2^k + 1), so it supports transforms of up to 2^k elements.
+ */
+struct BNNttPrime {
+    /**
+     * The prime modulus. Every modulus is less than 2^31.
+     */
+    BN_UINT32 modulus;
+
+    /**
+     * A primitive root modulo the prime.
+     */
+    BN_UINT32 generator;
+
+    /**
+     * Base-2 logarithm of the longest supported transform.
+     */
+    BN_UINT32 maxLog2;
+};
+
+/**
+ * Number of primes available for CRT reconstruction.
+ */
+enum : unsigned {
+    BN_NTT_NUM_PRIMES = 3
+};
+
+/**
+ * Primes used for exact convolution, ordered from largest to smallest. The
+ * product of the first one, two, or three primes is at least 2^30, 2^59, or
+ * 2^87, respectively.
+ */
+constexpr BNNttPrime BN_NTT_PRIMES[BN_NTT_NUM_PRIMES] = {
+    {2013265921, 31, 27},
+    {469762049,  3,  26},
+    {167772161,  3,  25}
+};
+
+
+
+/**
+ * Compute (b^e) mod m.
+ */
+bn_u64_t ntt_pow_mod(bn_u64_t b, bn_u64_t e, bn_u64_t m);
+
+/**
+ * Determine how many primes are required to exactly represent every output
+ * of a convolution.
+ * 
+ * @param The largest value a single digit can hold.
+ * 
+ * @param The length of the shorter convolution input.
+ * 
+ * @return The number of primes needed, or 0 if the convolution outputs can
+ * exceed the product of all available primes.
+ */
+unsigned ntt_num_primes(bn_u64_t maxDigit, ntt_size_t minLen);
+
+/**
+ * @return The length of the longest transform supported by the first
+ * "numPrimes" primes.
+ */
+ntt_size_t ntt_max_length(unsigned numPrimes);
+
+/**
+ * @return The power-of-two transform length required to convolve inputs of
+ * the given lengths without wrap-around.
+ */
+ntt_size_t ntt_length(ntt_size_t aLen, ntt_size_t bLen);
+
+/**
+ * In-place forward transform modulo BN_NTT_PRIMES[prime]. The input length
+ * must be a power of 2.
+ */
+void ntt_forward(ntt_list_t& x, unsigned prime);
+
+/**
+ * In-place inverse transform modulo BN_NTT_PRIMES[prime], including the
+ * final scaling by 1/len.
+ */
+void ntt_inverse(ntt_list_t& x, unsigned prime);
+
+/**
+ * Point-wise multiplication of two transformed lists. The result is stored in
+ * the first parameter. Both parameters may refer to the same list.
+ */
+void ntt_pointwise(ntt_list_t& x, const ntt_list_t& y, unsigned prime);
+
+/**
+ * Release all cached root-of-unity tables.
+ */
+void ntt_clear_roots();
+
+
+
+/**
+ * Reduce the digits of a number modulo BN_NTT_PRIMES[prime] into a zero-padded
+ * list of a given length.
+ */
+template <typename container_t>
+ntt_list_t create_ntt_table(const container_t& a, ntt_size_t len, unsigned prime);
+
+/**
+ * Reconstruct exact convolution outputs from their residues using the
+ * Chinese Remainder Theorem and propagate carries into a new number.
+ * 
+ * @param An array of "numPrimes" inverse-transformed residue lists.
+ * 
+ * @param The number of primes which were used.
+ * 
+ * @param The number of convolution outputs to reconstruct.
+ * 
+ * @return The normalized number, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t ntt_crt_carry(const ntt_list_t* residues, unsigned numPrimes, ntt_size_t count);
+
+
+
+#include "bignum/impl/ntt_impl.h"
+
+#endif	/* __BN_NTT_H__ */
@@ -0,0 +1,694 @@
+/*
+ * File:   bn_fourier.cpp
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bignum/fourier.h"
+
+/*
+ * Vectorized kernels are compiled for their own instruction sets using
+ * function attributes, then selected at runtime once the CPU has been
+ * queried. Other compilers and architectures use the scalar kernel.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    #define BN_FOURIER_X86
+    #include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Instruction set detection
+///////////////////////////////////////////////////////////////////////////////
+static bn_simd_t fft_detect_simd() {
+    #ifdef BN_FOURIER_X86
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f")) {
+            return BN_SIMD_AVX512;
+        }
+
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return BN_SIMD_AVX2;
+        }
+
+        if (__builtin_cpu_supports("sse2")) {
+            return BN_SIMD_SSE2;
+        }
+    #endif
+
+    return BN_SIMD_NONE;
+}
+
+
+
+static std::atomic<int>& fft_simd_state() {
+    static std::atomic<int> level{(int)fft_simd_support()};
+    return level;
+}
+
+
+
+bn_simd_t fft_simd_support() {
+    static const bn_simd_t support = fft_detect_simd();
+    return support;
+}
+
+
+
+bn_simd_t fft_simd_level() {
+    return (bn_simd_t)fft_simd_state().load(std::memory_order_relaxed);
+}
+
+
+
+void fft_set_simd_level(bn_simd_t level) {
+    const bn_simd_t support = fft_simd_support();
+    fft_simd_state().store((int)(level < support ? level : support), std::memory_order_relaxed);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Four-step transforms
+///////////////////////////////////////////////////////////////////////////////
+static std::atomic<std::size_t>& fft_four_step_state() {
+    static std::atomic<std::size_t> len{0};
+    return len;
+}
+
+
+
+std::size_t fft_four_step_length() {
+    return fft_four_step_state().load(std::memory_order_relaxed);
+}
+
+
+
+void fft_set_four_step_length(std::size_t len) {
+    fft_four_step_state().store(len, std::memory_order_relaxed);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Parallel transforms
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Worker threads which are kept alive between transforms. Only one job runs
+ * on the pool at a time, and the thread which submits a job also works on
+ * it until every task has been claimed.
+ */
+struct BNFourierPool {
+    std::mutex submitLock; // held by the thread running a job
+    std::mutex lock; // guards the job state below
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::vector<std::thread> workers;
+
+    const std::function<void(std::size_t)>* task = nullptr;
+    std::size_t numTasks = 0;
+    std::atomic<std::size_t> nextTask{0};
+    std::size_t numBusy = 0;
+    std::size_t generation = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    std::atomic<std::size_t> numThreads{0};
+    std::atomic<std::size_t> parallelLength{65536};
+
+    std::mutex executorLock;
+    std::shared_ptr<const bn_executor_t> executor;
+
+    static BNFourierPool& instance() {
+        static BNFourierPool pool;
+        return pool;
+    }
+
+    ~BNFourierPool() {
+        stop();
+    }
+
+    void run_tasks();
+    void work(std::size_t seen);
+    void stop();
+    void resize(std::size_t numWorkers);
+    void run(std::size_t jobSize, const std::function<void(std::size_t)>& jobTask);
+};
+
+
+
+// Set while a thread runs part of a parallel job, so nested jobs run serially.
+static thread_local bool fftInParallelTask = false;
+
+struct BNParallelTaskScope {
+    const bool wasInTask;
+
+    BNParallelTaskScope() : wasInTask{fftInParallelTask} {
+        fftInParallelTask = true;
+    }
+
+    ~BNParallelTaskScope() {
+        fftInParallelTask = wasInTask;
+    }
+};
+
+
+
+void BNFourierPool::run_tasks() {
+    const BNParallelTaskScope scope;
+
+    for (std::size_t i = nextTask++; i < numTasks; i = nextTask++) {
+        try {
+            (*task)(i);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> guard{lock};
+
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+}
+
+
+
+void BNFourierPool::work(std::size_t seen) {
+    std::unique_lock<std::mutex> guard{lock};
+
+    for (;;) {
+        wake.wait(guard, [&]() {
+            return stopping || generation != seen;
+        });
+
+        if (stopping) {
+            return;
+        }
+
+        seen = generation;
+
+        guard.unlock();
+        run_tasks();
+        guard.lock();
+
+        if (--numBusy == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+
+
+void BNFourierPool::stop() {
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    workers.clear();
+    stopping = false;
+}
+
+
+
+void BNFourierPool::resize(std::size_t numWorkers) {
+    if (workers.size() == numWorkers) {
+        return;
+    }
+
+    stop();
+
+    // New workers must not mistake the previous job for a new one.
+    const std::size_t seen = generation;
+
+    for (std::size_t i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(&BNFourierPool::work, this, seen);
+    }
+}
+
+
+
+void BNFourierPool::run(std::size_t jobSize, const std::function<void(std::size_t)>& jobTask) {
+    resize(fft_num_threads() - 1);
+
+    {
+        std::lock_guard<std::mutex> guard{lock};
+        task = &jobTask;
+        numTasks = jobSize;
+        nextTask = 0;
+        numBusy = workers.size();
+        error = nullptr;
+        ++generation;
+    }
+
+    wake.notify_all();
+    run_tasks();
+
+    std::unique_lock<std::mutex> guard{lock};
+
+    done.wait(guard, [&]() {
+        return numBusy == 0;
+    });
+
+    task = nullptr;
+
+    if (error) {
+        std::exception_ptr e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+
+
+std::size_t fft_num_threads() {
+    const std::size_t numThreads = BNFourierPool::instance().numThreads.load(std::memory_order_relaxed);
+
+    if (numThreads) {
+        return numThreads;
+    }
+
+    const std::size_t numCores = std::thread::hardware_concurrency();
+    return numCores ? numCores : 1;
+}
+
+
+
+void fft_set_num_threads(std::size_t numThreads) {
+    BNFourierPool::instance().numThreads.store(numThreads, std::memory_order_relaxed);
+}
+
+
+
+std::size_t fft_parallel_length() {
+    return BNFourierPool::instance().parallelLength.load(std::memory_order_relaxed);
+}
+
+
+
+void fft_set_parallel_length(std::size_t len) {
+    BNFourierPool::instance().parallelLength.store(len, std::memory_order_relaxed);
+}
+
+
+
+void fft_set_executor(const bn_executor_t& executor) {
+    BNFourierPool& pool = BNFourierPool::instance();
+    std::shared_ptr<const bn_executor_t> next;
+
+    if (executor) {
+        next.reset(new bn_executor_t{executor});
+    }
+
+    std::lock_guard<std::mutex> guard{pool.executorLock};
+    pool.executor = std::move(next);
+}
+
+
+
+void fft_parallel_for(std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+    BNFourierPool& pool = BNFourierPool::instance();
+
+    // Nested jobs, and jobs submitted while the pool is busy with another
+    // thread's transform, run on the calling thread.
+    const auto run_serial = [&]() {
+        for (std::size_t i = 0; i < numTasks; ++i) {
+            task(i);
+        }
+    };
+
+    if (numTasks < 2 || fftInParallelTask) {
+        run_serial();
+        return;
+    }
+
+    std::shared_ptr<const bn_executor_t> executor;
+
+    {
+        std::lock_guard<std::mutex> guard{pool.executorLock};
+        executor = pool.executor;
+    }
+
+    if (executor) {
+        (*executor)(numTasks, [&](std::size_t i) {
+            const BNParallelTaskScope scope;
+            task(i);
+        });
+        return;
+    }
+
+    if (fft_num_threads() < 2) {
+        run_serial();
+        return;
+    }
+
+    std::unique_lock<std::mutex> submitGuard{pool.submitLock, std::try_to_lock};
+
+    if (!submitGuard.owns_lock()) {
+        run_serial();
+        return;
+    }
+
+    pool.run(numTasks, task);
+}
+
+
+
+#ifdef BN_FOURIER_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// SSE2 butterflies
+///////////////////////////////////////////////////////////////////////////////
+__attribute__((target("sse2")))
+static void fft_butterflies_sse2(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        double* const evenRe = re + i;
+        double* const evenIm = im + i;
+        double* const oddRe = re + i + span;
+        double* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; k += 2) {
+            const __m128d wr = _mm_loadu_pd(wRe + k);
+            const __m128d wi = _mm_loadu_pd(wIm + k);
+            const __m128d xr = _mm_loadu_pd(oddRe + k);
+            const __m128d xi = _mm_loadu_pd(oddIm + k);
+            const __m128d er = _mm_loadu_pd(evenRe + k);
+            const __m128d ei = _mm_loadu_pd(evenIm + k);
+
+            const __m128d tr = _mm_sub_pd(_mm_mul_pd(xr, wr), _mm_mul_pd(xi, wi));
+            const __m128d ti = _mm_add_pd(_mm_mul_pd(xr, wi), _mm_mul_pd(xi, wr));
+
+            _mm_storeu_pd(evenRe + k, _mm_add_pd(er, tr));
+            _mm_storeu_pd(evenIm + k, _mm_add_pd(ei, ti));
+            _mm_storeu_pd(oddRe + k, _mm_sub_pd(er, tr));
+            _mm_storeu_pd(oddIm + k, _mm_sub_pd(ei, ti));
+        }
+    }
+}
+
+
+
+__attribute__((target("sse2")))
+static void fft_butterflies_sse2(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        float* const evenRe = re + i;
+        float* const evenIm = im + i;
+        float* const oddRe = re + i + span;
+        float* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; k += 4) {
+            const __m128 wr = _mm_loadu_ps(wRe + k);
+            const __m128 wi = _mm_loadu_ps(wIm + k);
+            const __m128 xr = _mm_loadu_ps(oddRe + k);
+            const __m128 xi = _mm_loadu_ps(oddIm + k);
+            const __m128 er = _mm_loadu_ps(evenRe + k);
+            const __m128 ei = _mm_loadu_ps(evenIm + k);
+
+            const __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, wr), _mm_mul_ps(xi, wi));
+            const __m128 ti = _mm_add_ps(_mm_mul_ps(xr, wi), _mm_mul_ps(xi, wr));
+
+            _mm_storeu_ps(evenRe + k, _mm_add_ps(er, tr));
+            _mm_storeu_ps(evenIm + k, _mm_add_ps(ei, ti));
+            _mm_storeu_ps(oddRe + k, _mm_sub_ps(er, tr));
+            _mm_storeu_ps(oddIm + k, _mm_sub_ps(ei, ti));
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2 butterflies
+///////////////////////////////////////////////////////////////////////////////
+__attribute__((target("avx2,fma")))
+static void fft_butterflies_avx2(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        double* const evenRe = re + i;
+        double* const evenIm = im + i;
+        double* const oddRe = re + i + span;
+        double* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; k += 4) {
+            const __m256d wr = _mm256_loadu_pd(wRe + k);
+            const __m256d wi = _mm256_loadu_pd(wIm + k);
+            const __m256d xr = _mm256_loadu_pd(oddRe + k);
+            const __m256d xi = _mm256_loadu_pd(oddIm + k);
+            const __m256d er = _mm256_loadu_pd(evenRe + k);
+            const __m256d ei = _mm256_loadu_pd(evenIm + k);
+
+            const __m256d tr = _mm256_fmsub_pd(xr, wr, _mm256_mul_pd(xi, wi));
+            const __m256d ti = _mm256_fmadd_pd(xr, wi, _mm256_mul_pd(xi, wr));
+
+            _mm256_storeu_pd(evenRe + k, _mm256_add_pd(er, tr));
+            _mm256_storeu_pd(evenIm + k, _mm256_add_pd(ei, ti));
+            _mm256_storeu_pd(oddRe + k, _mm256_sub_pd(er, tr));
+            _mm256_storeu_pd(oddIm + k, _mm256_sub_pd(ei, ti));
+        }
+    }
+}
+
+
+
+__attribute__((target("avx2,fma")))
+static void fft_butterflies_avx2(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        float* const evenRe = re + i;
+        float* const evenIm = im + i;
+        float* const oddRe = re + i + span;
+        float* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; k += 8) {
+            const __m256 wr = _mm256_loadu_ps(wRe + k);
+            const __m256 wi = _mm256_loadu_ps(wIm + k);
+            const __m256 xr = _mm256_loadu_ps(oddRe + k);
+            const __m256 xi = _mm256_loadu_ps(oddIm + k);
+            const __m256 er = _mm256_loadu_ps(evenRe + k);
+            const __m256 ei = _mm256_loadu_ps(evenIm + k);
+
+            const __m256 tr = _mm256_fmsub_ps(xr, wr, _mm256_mul_ps(xi, wi));
+            const __m256 ti = _mm256_fmadd_ps(xr, wi, _mm256_mul_ps(xi, wr));
+
+            _mm256_storeu_ps(evenRe + k, _mm256_add_ps(er, tr));
+            _mm256_storeu_ps(evenIm + k, _mm256_add_ps(ei, ti));
+            _mm256_storeu_ps(oddRe + k, _mm256_sub_ps(er, tr));
+            _mm256_storeu_ps(oddIm + k, _mm256_sub_ps(ei, ti));
+        }
+    }
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX-512 butterflies
+///////////////////////////////////////////////////////////////////////////////
+__attribute__((target("avx512f")))
+static void fft_butterflies_avx512(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        double* const evenRe = re + i;
+        double* const evenIm = im + i;
+        double* const oddRe = re + i + span;
+        double* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; k += 8) {
+            const __m512d wr = _mm512_loadu_pd(wRe + k);
+            const __m512d wi = _mm512_loadu_pd(wIm + k);
+            const __m512d xr = _mm512_loadu_pd(oddRe + k);
+            const __m512d xi = _mm512_loadu_pd(oddIm + k);
+            const __m512d er = _mm512_loadu_pd(evenRe + k);
+            const __m512d ei = _mm512_loadu_pd(evenIm + k);
+
+            const __m512d tr = _mm512_fmsub_pd(xr, wr, _mm512_mul_pd(xi, wi));
+            const __m512d ti = _mm512_fmadd_pd(xr, wi, _mm512_mul_pd(xi, wr));
+
+            _mm512_storeu_pd(evenRe + k, _mm512_add_pd(er, tr));
+            _mm512_storeu_pd(evenIm + k, _mm512_add_pd(ei, ti));
+            _mm512_storeu_pd(oddRe + k, _mm512_sub_pd(er, tr));
+            _mm512_storeu_pd(oddIm + k, _mm512_sub_pd(ei, ti));
+        }
+    }
+}
+
+
+
+__attribute__((target("avx512f")))
+static void fft_butterflies_avx512(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    for (std::size_t i = 0; i < len; i += span << 1) {
+        float* const evenRe = re + i;
+        float* const evenIm = im + i;
+        float* const oddRe = re + i + span;
+        float* const oddIm = im + i + span;
+
+        for (std::size_t k = 0; k < count; k += 16) {
+            const __m512 wr = _mm512_loadu_ps(wRe + k);
+            const __m512 wi = _mm512_loadu_ps(wIm + k);
+            const __m512 xr = _mm512_loadu_ps(oddRe + k);
+            const __m512 xi = _mm512_loadu_ps(oddIm + k);
+            const __m512 er = _mm512_loadu_ps(evenRe + k);
+            const __m512 ei = _mm512_loadu_ps(evenIm + k);
+
+            const __m512 tr = _mm512_fmsub_ps(xr, wr, _mm512_mul_ps(xi, wi));
+            const __m512 ti = _mm512_fmadd_ps(xr, wi, _mm512_mul_ps(xi, wr));
+
+            _mm512_storeu_ps(evenRe + k, _mm512_add_ps(er, tr));
+            _mm512_storeu_ps(evenIm + k, _mm512_add_ps(ei, ti));
+            _mm512_storeu_ps(oddRe + k, _mm512_sub_ps(er, tr));
+            _mm512_storeu_ps(oddIm + k, _mm512_sub_ps(ei, ti));
+        }
+    }
+}
+
+#endif /* BN_FOURIER_X86 */
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Butterfly dispatch
+//
+// Each pass uses the widest enabled instruction set whose vector length fits
+// within the columns being processed. The first few passes of every
+// transform are too narrow for any vector and use the scalar kernel, as do
+// the last columns of strips which are not a multiple of the vector length.
+///////////////////////////////////////////////////////////////////////////////
+template <typename flt_t>
+static void fft_butterflies_tail(
+    flt_t* re, flt_t* im,
+    const flt_t* wRe, const flt_t* wIm,
+    std::size_t len, std::size_t span, std::size_t first, std::size_t count
+) {
+    if (first < count) {
+        fft_butterflies_scalar<flt_t>(re + first, im + first, wRe + first, wIm + first, len, span, count - first);
+    }
+}
+
+
+
+void fft_butterflies(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    #ifdef BN_FOURIER_X86
+        const bn_simd_t level = fft_simd_level();
+
+        if (level >= BN_SIMD_AVX512 && count >= 16) {
+            const std::size_t vecCount = count & ~std::size_t{15};
+
+            fft_butterflies_avx512(re, im, wRe, wIm, len, span, vecCount);
+            fft_butterflies_tail(re, im, wRe, wIm, len, span, vecCount, count);
+            return;
+        }
+
+        if (level >= BN_SIMD_AVX2 && count >= 8) {
+            const std::size_t vecCount = count & ~std::size_t{7};
+
+            fft_butterflies_avx2(re, im, wRe, wIm, len, span, vecCount);
+            fft_butterflies_tail(re, im, wRe, wIm, len, span, vecCount, count);
+            return;
+        }
+
+        if (level >= BN_SIMD_SSE2 && count >= 4) {
+            const std::size_t vecCount = count & ~std::size_t{3};
+
+            fft_butterflies_sse2(re, im, wRe, wIm, len, span, vecCount);
+            fft_butterflies_tail(re, im, wRe, wIm, len, span, vecCount, count);
+            return;
+        }
+    #endif
+
+    fft_butterflies_scalar<float>(re, im, wRe, wIm, len, span, count);
+}
+
+
+
+void fft_butterflies(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span, std::size_t count
+) {
+    #ifdef BN_FOURIER_X86
+        const bn_simd_t level = fft_simd_level();
+
+        if (level >= BN_SIMD_AVX512 && count >= 8) {
+            const std::size_t vecCount = count & ~std::size_t{7};
+
+            fft_butterflies_avx512(re, im, wRe, wIm, len, span, vecCount);
+            fft_butterflies_tail(re, im, wRe, wIm, len, span, vecCount, count);
+            return;
+        }
+
+        if (level >= BN_SIMD_AVX2 && count >= 4) {
+            const std::size_t vecCount = count & ~std::size_t{3};
+
+            fft_butterflies_avx2(re, im, wRe, wIm, len, span, vecCount);
+            fft_butterflies_tail(re, im, wRe, wIm, len, span, vecCount, count);
+            return;
+        }
+
+        if (level >= BN_SIMD_SSE2 && count >= 2) {
+            const std::size_t vecCount = count & ~std::size_t{1};
+
+            fft_butterflies_sse2(re, im, wRe, wIm, len, span, vecCount);
+            fft_butterflies_tail(re, im, wRe, wIm, len, span, vecCount, count);
+            return;
+        }
+    #endif
+
+    fft_butterflies_scalar<double>(re, im, wRe, wIm, len, span, count);
+}
+
+
+
+void fft_butterflies(
+    float* re, float* im,
+    const float* wRe, const float* wIm,
+    std::size_t len, std::size_t span
+) {
+    fft_butterflies(re, im, wRe, wIm, len, span, span);
+}
+
+
+
+void fft_butterflies(
+    double* re, double* im,
+    const double* wRe, const double* wIm,
+    std::size_t len, std::size_t span
+) {
+    fft_butterflies(re, im, wRe, wIm, len, span, span);
+}
@@ -0,0 +1,234 @@
+/*
+ * File:   bn_multiplication.cpp
+ */
+
+#include "bignum/bignum.h"
+
+/*
+ * As with the FFT butterflies, vectorized column sums are compiled for their
+ * own instruction set and selected at runtime. Their horizontal sums need
+ * 64-bit general-purpose registers.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #define BN_MULTIPLICATION_X86
+    #include <immintrin.h>
+#endif
+
+
+
+#ifdef BN_MULTIPLICATION_X86
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2 dot products
+//
+// _mm256_mul_epu32() multiplies the low 32 bits of each 64-bit lane, so the
+// even and odd digits of a vector are multiplied separately. 32-bit products
+// are split into their low and high halves, while 16-bit products are summed
+// whole.
+///////////////////////////////////////////////////////////////////////////////
+__attribute__((target("avx2")))
+static inline bn_u64_t bn_hsum_avx2(__m256i v) {
+    const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return (bn_u64_t)_mm_cvtsi128_si64(sum) + (bn_u64_t)_mm_extract_epi64(sum, 1);
+}
+
+
+
+__attribute__((target("avx2")))
+static inline void bn_dot_avx2(const BN_UINT32* x, const BN_UINT32* y, std::size_t len, bn_u64_t& lo, bn_u64_t& hi) {
+    bn_u64_t sumLo = 0;
+    bn_u64_t sumHi = 0;
+    std::size_t i = 0;
+
+    if (len >= 8) {
+        const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+        __m256i accLo = _mm256_setzero_si256();
+        __m256i accHi = _mm256_setzero_si256();
+
+        for (; i + 8 <= len; i += 8) {
+            const __m256i xv = _mm256_loadu_si256((const __m256i*)(x + i));
+            const __m256i yv = _mm256_loadu_si256((const __m256i*)(y + i));
+            const __m256i even = _mm256_mul_epu32(xv, yv);
+            const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(xv, 32), _mm256_srli_epi64(yv, 32));
+
+            accLo = _mm256_add_epi64(accLo, _mm256_and_si256(even, mask));
+            accLo = _mm256_add_epi64(accLo, _mm256_and_si256(odd, mask));
+            accHi = _mm256_add_epi64(accHi, _mm256_srli_epi64(even, 32));
+            accHi = _mm256_add_epi64(accHi, _mm256_srli_epi64(odd, 32));
+        }
+
+        sumLo = bn_hsum_avx2(accLo);
+        sumHi = bn_hsum_avx2(accHi);
+    }
+
+    for (; i < len; ++i) {
+        const bn_u64_t product = (bn_u64_t)x[i] * (bn_u64_t)y[i];
+        sumLo += product & 0xFFFFFFFF;
+        sumHi += product >> 32;
+    }
+
+    lo = sumLo;
+    hi = sumHi;
+}
+
+
+
+__attribute__((target("avx2")))
+static inline void bn_dot_avx2(const BN_UINT16* x, const BN_UINT16* y, std::size_t len, bn_u64_t& lo, bn_u64_t& hi) {
+    bn_u64_t sum = 0;
+    std::size_t i = 0;
+
+    if (len >= 8) {
+        __m256i acc = _mm256_setzero_si256();
+
+        for (; i + 8 <= len; i += 8) {
+            const __m256i xv = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(x + i)));
+            const __m256i yv = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(y + i)));
+            const __m256i even = _mm256_mul_epu32(xv, yv);
+            const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(xv, 32), _mm256_srli_epi64(yv, 32));
+
+            acc = _mm256_add_epi64(acc, _mm256_add_epi64(even, odd));
+        }
+
+        sum = bn_hsum_avx2(acc);
+    }
+
+    for (; i < len; ++i) {
+        sum += (bn_u64_t)x[i] * (bn_u64_t)y[i];
+    }
+
+    lo = sum;
+    hi = 0;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// AVX2 column sums
+///////////////////////////////////////////////////////////////////////////////
+template <typename digit_t>
+__attribute__((target("avx2")))
+static void bn_column_sums_avx2(
+    const digit_t* x, std::size_t xLen,
+    const digit_t* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    for (std::size_t k = 0; k + 1 < xLen + yLen; ++k) {
+        const std::size_t first = (k < yLen) ? 0 : k - yLen + 1;
+        const std::size_t last = (k < xLen) ? k + 1 : xLen;
+
+        bn_dot_avx2(x + first, yRev + (yLen-1+first-k), last - first, lo[k], hi[k]);
+    }
+}
+
+
+
+template <typename digit_t>
+__attribute__((target("avx2")))
+static void bn_column_squares_avx2(
+    const digit_t* x, const digit_t* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    static constexpr unsigned DIGIT_BITS = 8 * sizeof(digit_t);
+
+    for (std::size_t k = 0; k + 1 < 2*len; ++k) {
+        const std::size_t first = (k < len) ? 0 : k - len + 1;
+        const std::size_t mid = (k + 1) / 2;
+
+        bn_u64_t sumLo = 0;
+        bn_u64_t sumHi = 0;
+
+        if (mid > first) {
+            bn_dot_avx2(x + first, xRev + (len-1+first-k), mid - first, sumLo, sumHi);
+        }
+
+        sumLo *= 2;
+        sumHi *= 2;
+
+        if (!(k & 1)) {
+            const bn_u64_t square = (bn_u64_t)x[k/2] * (bn_u64_t)x[k/2];
+
+            if (DIGIT_BITS > 16) {
+                sumLo += square & 0xFFFFFFFF;
+                sumHi += square >> 32;
+            }
+            else {
+                sumLo += square;
+            }
+        }
+
+        lo[k] = sumLo;
+        hi[k] = sumHi;
+    }
+}
+
+#endif /* BN_MULTIPLICATION_X86 */
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Column sum dispatch
+///////////////////////////////////////////////////////////////////////////////
+void bn_column_sums(
+    const BN_UINT16* x, std::size_t xLen,
+    const BN_UINT16* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    #ifdef BN_MULTIPLICATION_X86
+        if (fft_simd_level() >= BN_SIMD_AVX2) {
+            bn_column_sums_avx2<BN_UINT16>(x, xLen, yRev, yLen, lo, hi);
+            return;
+        }
+    #endif
+
+    bn_column_sums<BN_UINT16>(x, xLen, yRev, yLen, lo, hi);
+}
+
+
+
+void bn_column_sums(
+    const BN_UINT32* x, std::size_t xLen,
+    const BN_UINT32* yRev, std::size_t yLen,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    #ifdef BN_MULTIPLICATION_X86
+        if (fft_simd_level() >= BN_SIMD_AVX2) {
+            bn_column_sums_avx2<BN_UINT32>(x, xLen, yRev, yLen, lo, hi);
+            return;
+        }
+    #endif
+
+    bn_column_sums<BN_UINT32>(x, xLen, yRev, yLen, lo, hi);
+}
+
+
+
+void bn_column_squares(
+    const BN_UINT16* x, const BN_UINT16* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    #ifdef BN_MULTIPLICATION_X86
+        if (fft_simd_level() >= BN_SIMD_AVX2) {
+            bn_column_squares_avx2<BN_UINT16>(x, xRev, len, lo, hi);
+            return;
+        }
+    #endif
+
+    bn_column_squares<BN_UINT16>(x, xRev, len, lo, hi);
+}
+
+
+
+void bn_column_squares(
+    const BN_UINT32* x, const BN_UINT32* xRev, std::size_t len,
+    bn_u64_t* lo, bn_u64_t* hi
+) {
+    #ifdef BN_MULTIPLICATION_X86
+        if (fft_simd_level() >= BN_SIMD_AVX2) {
+            bn_column_squares_avx2<BN_UINT32>(x, xRev, len, lo, hi);
+            return;
+        }
+    #endif
+
+    bn_column_squares<BN_UINT32>(x, xRev, len, lo, hi);
+}
@@ -0,0 +1,228 @@
+/* 
+ * File:   bn_ntt.cpp
+ */
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "bignum/bn_except.h"
+#include "bignum/ntt.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Root-of-unity tables
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Roots of unity for a single transform length, along with Shoup's
+ * precomputed quotients floor(w * 2^32 / p) for fast modular multiplication.
+ */
+struct BNNttRoots {
+    ntt_list_t roots;
+    ntt_list_t quotients;
+};
+
+typedef std::shared_ptr<const BNNttRoots> ntt_roots_t;
+
+/*
+ * Shared cache of root tables, keyed by prime index and transform length.
+ */
+struct BNNttCache {
+    std::mutex lock;
+    std::map<std::pair<unsigned, ntt_size_t>, ntt_roots_t> roots;
+
+    static BNNttCache& instance() {
+        static BNNttCache cache;
+        return cache;
+    }
+};
+
+/*
+ * Retrieve (or build) the first (len/2) powers of a primitive len'th root of
+ * unity modulo a prime.
+ */
+static ntt_roots_t ntt_roots(unsigned prime, ntt_size_t len) {
+    BNNttCache& cache = BNNttCache::instance();
+    const std::pair<unsigned, ntt_size_t> key{prime, len};
+
+    {
+        std::lock_guard<std::mutex> guard{cache.lock};
+        const auto iter = cache.roots.find(key);
+
+        if (iter != cache.roots.end()) {
+            return iter->second;
+        }
+    }
+
+    const bn_u64_t p = BN_NTT_PRIMES[prime].modulus;
+    const bn_u64_t w = ntt_pow_mod(BN_NTT_PRIMES[prime].generator, (p-1) / len, p);
+    const ntt_size_t halfLen = len / 2;
+
+    std::shared_ptr<BNNttRoots> table{new BNNttRoots{}};
+    table->roots.reserve(halfLen);
+    table->quotients.reserve(halfLen);
+
+    for (ntt_size_t k = 0, wk = 1; k < halfLen; ++k) {
+        table->roots.push_back((BN_UINT32)wk);
+        table->quotients.push_back((BN_UINT32)(((bn_u64_t)wk << 32) / p));
+        wk = wk * w % p;
+    }
+
+    std::lock_guard<std::mutex> guard{cache.lock};
+    return cache.roots.emplace(key, std::move(table)).first->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Modular arithmetic
+///////////////////////////////////////////////////////////////////////////////
+bn_u64_t ntt_pow_mod(bn_u64_t b, bn_u64_t e, bn_u64_t m) {
+    bn_u64_t ret = 1 % m;
+    b %= m;
+
+    while (e) {
+        if (e & 1) {
+            ret = ret * b % m;
+        }
+
+        b = b * b % m;
+        e >>= 1;
+    }
+
+    return ret;
+}
+
+/*
+ * Multiply x by a fixed root w, modulo p, using Shoup's method. Requires that
+ * x < 2^32 and wq = floor(w * 2^32 / p).
+ */
+static inline BN_UINT32 ntt_mul_shoup(bn_u64_t x, bn_u64_t w, bn_u64_t wq, bn_u64_t p) {
+    const bn_u64_t q = (x * wq) >> 32;
+    const bn_u64_t r = (x * w - q * p) & 0xFFFFFFFF;
+    return (BN_UINT32)(r >= p ? r - p : r);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Transform parameters
+///////////////////////////////////////////////////////////////////////////////
+unsigned ntt_num_primes(bn_u64_t maxDigit, ntt_size_t minLen) {
+    // Every convolution output is less than minLen * (maxDigit+1)^2.
+    const bn_u64_t numBits = 2 * bn_bit_width(maxDigit) + bn_bit_width(minLen);
+
+    if (numBits <= 30) {
+        return 1;
+    }
+    else if (numBits <= 59) {
+        return 2;
+    }
+    else if (numBits <= 87) {
+        return 3;
+    }
+
+    return 0;
+}
+
+ntt_size_t ntt_max_length(unsigned numPrimes) {
+    BN_ASSERT(numPrimes > 0 && numPrimes <= BN_NTT_NUM_PRIMES);
+
+    // primes are sorted by decreasing transform length
+    return ntt_size_t{1} << BN_NTT_PRIMES[numPrimes-1].maxLog2;
+}
+
+ntt_size_t ntt_length(ntt_size_t aLen, ntt_size_t bLen) {
+    const ntt_size_t outLen = (aLen + bLen > 1) ? (aLen + bLen - 1) : 1;
+    ntt_size_t len = 1;
+
+    while (len < outLen) {
+        len <<= 1;
+    }
+
+    return len;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Transforms
+///////////////////////////////////////////////////////////////////////////////
+void ntt_forward(ntt_list_t& x, unsigned prime) {
+    const ntt_size_t len = x.size();
+
+    if (len < 2) {
+        return;
+    }
+
+    BN_ASSERT(!(len & (len-1)) && len <= ntt_max_length(prime+1));
+
+    // bit-reversal permutation
+    for (ntt_size_t i = 1, j = 0; i < len; ++i) {
+        ntt_size_t bit = len >> 1;
+
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+
+        j ^= bit;
+
+        if (i < j) {
+            std::swap(x[i], x[j]);
+        }
+    }
+
+    const bn_u64_t p = BN_NTT_PRIMES[prime].modulus;
+    const ntt_roots_t rootTable = ntt_roots(prime, len);
+    const ntt_list_t& roots = rootTable->roots;
+    const ntt_list_t& quotients = rootTable->quotients;
+    const ntt_size_t halfLen = len / 2;
+
+    for (ntt_size_t span = 1; span < len; span <<= 1) {
+        const ntt_size_t stride = halfLen / span;
+
+        for (ntt_size_t i = 0; i < len; i += span << 1) {
+            for (ntt_size_t k = 0; k < span; ++k) {
+                const bn_u64_t even = x[i+k];
+                const bn_u64_t odd = ntt_mul_shoup(x[i+k+span], roots[k*stride], quotients[k*stride], p);
+                const bn_u64_t sum = even + odd;
+                const bn_u64_t diff = even + p - odd;
+
+                x[i+k] = (BN_UINT32)(sum >= p ? sum - p : sum);
+                x[i+k+span] = (BN_UINT32)(diff >= p ? diff - p : diff);
+            }
+        }
+    }
+}
+
+void ntt_inverse(ntt_list_t& x, unsigned prime) {
+    const ntt_size_t len = x.size();
+
+    if (len < 2) {
+        return;
+    }
+
+    // The inverse transform is the forward transform with its outputs, other
+    // than the first, in reverse order.
+    ntt_forward(x, prime);
+    std::reverse(x.begin()+1, x.end());
+
+    const bn_u64_t p = BN_NTT_PRIMES[prime].modulus;
+    const bn_u64_t scale = ntt_pow_mod(len % p, p-2, p);
+    const bn_u64_t scaleQ = (scale << 32) / p;
+
+    for (BN_UINT32& e : x) {
+        e = ntt_mul_shoup(e, scale, scaleQ, p);
+    }
+}
+
+void ntt_pointwise(ntt_list_t& x, const ntt_list_t& y, unsigned prime) {
+    BN_ASSERT(x.size() == y.size());
+
+    const bn_u64_t p = BN_NTT_PRIMES[prime].modulus;
+
+    for (ntt_size_t i = 0; i < x.size(); ++i) {
+        x[i] = (BN_UINT32)((bn_u64_t)x[i] * y[i] % p);
+    }
+}
+
+void ntt_clear_roots() {
+    BNNttCache& cache = BNNttCache::instance();
+    std::lock_guard<std::mutex> guard{cache.lock};
+    cache.roots.clear();
+}
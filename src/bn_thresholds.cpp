@@ -0,0 +1,144 @@
+/* 
+ * File:   bn_thresholds.cpp
+ */
+
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bignum/bignum.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// Bignum thresholds
+///////////////////////////////////////////////////////////////////////////////
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_lowp);
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_medp);
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_highp);
+
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_base2);
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_base8);
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_base10);
+BN_DEFINE_STRUCT(BNThresholds, bn_limits_base16);
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Threshold configuration files
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Lengths below "minValue" are rejected when loading a file. The algorithms
+ * would fall back to simpler methods at those lengths anyway, so a smaller
+ * value can only come from a mistake.
+ */
+struct BNThresholdField {
+    std::string name;
+    std::size_t* value;
+    std::size_t minValue;
+};
+
+
+
+template <typename limits_t>
+static void bn_add_threshold_fields(std::vector<BNThresholdField>& fields, const std::string& typeName) {
+    fields.push_back(BNThresholdField{typeName + ".mulKaratsuba", &BNThresholds<limits_t>::mulKaratsuba, 4});
+    fields.push_back(BNThresholdField{typeName + ".sqrKaratsuba", &BNThresholds<limits_t>::sqrKaratsuba, 4});
+    fields.push_back(BNThresholdField{typeName + ".mulToom3", &BNThresholds<limits_t>::mulToom3, BN_TOOM_MIN_LEN});
+    fields.push_back(BNThresholdField{typeName + ".mulToom4", &BNThresholds<limits_t>::mulToom4, BN_TOOM_MIN_LEN});
+    fields.push_back(BNThresholdField{typeName + ".mulFFT", &BNThresholds<limits_t>::mulFFT, 1});
+    fields.push_back(BNThresholdField{typeName + ".mulUnbalanced", &BNThresholds<limits_t>::mulUnbalanced, 1});
+    fields.push_back(BNThresholdField{typeName + ".divBurnikel", &BNThresholds<limits_t>::divBurnikel, BN_BURNIKEL_MIN_LEN});
+    fields.push_back(BNThresholdField{typeName + ".divNewton", &BNThresholds<limits_t>::divNewton, BN_NEWTON_MIN_LEN});
+    fields.push_back(BNThresholdField{typeName + ".divBarrett", &BNThresholds<limits_t>::divBarrett, BN_NEWTON_MIN_LEN});
+    fields.push_back(BNThresholdField{typeName + ".divExact", &BNThresholds<limits_t>::divExact, BN_EXACT_MIN_LEN});
+}
+
+
+
+static std::vector<BNThresholdField> bn_threshold_fields() {
+    std::vector<BNThresholdField> fields;
+
+    bn_add_threshold_fields<bn_limits_lowp>(fields, "lowp");
+    bn_add_threshold_fields<bn_limits_medp>(fields, "medp");
+    bn_add_threshold_fields<bn_limits_highp>(fields, "highp");
+
+    bn_add_threshold_fields<bn_limits_base2>(fields, "base2");
+    bn_add_threshold_fields<bn_limits_base8>(fields, "base8");
+    bn_add_threshold_fields<bn_limits_base10>(fields, "base10");
+    bn_add_threshold_fields<bn_limits_base16>(fields, "base16");
+
+    return fields;
+}
+
+
+
+bool bn_load_thresholds(std::istream& stream) {
+    const std::vector<BNThresholdField> fields = bn_threshold_fields();
+
+    bool ret = true;
+    std::string line;
+
+    while (std::getline(stream, line)) {
+        line = line.substr(0, line.find('#'));
+
+        const std::string::size_type split = line.find('=');
+        std::istringstream nameParser{line.substr(0, split)};
+        std::string name;
+
+        if (split == std::string::npos) {
+            // Only blank lines may leave out an assignment
+            ret = ret && !(nameParser >> name);
+            continue;
+        }
+
+        std::istringstream valueParser{line.substr(split+1)};
+        std::size_t value;
+
+        if (!(nameParser >> name) || !(nameParser >> std::ws).eof()
+        || !(valueParser >> value) || !(valueParser >> std::ws).eof()
+        ) {
+            ret = false;
+            continue;
+        }
+
+        bool valid = false;
+
+        for (const BNThresholdField& field : fields) {
+            if (field.name == name) {
+                valid = value >= field.minValue;
+
+                if (valid) {
+                    *field.value = value;
+                }
+
+                break;
+            }
+        }
+
+        ret = ret && valid;
+    }
+
+    return ret;
+}
+
+
+
+bool bn_load_thresholds(const char* fileName) {
+    std::ifstream stream{fileName};
+
+    if (!stream) {
+        return false;
+    }
+
+    return bn_load_thresholds(stream);
+}
+
+
+
+void bn_save_thresholds(std::ostream& stream) {
+    for (const BNThresholdField& field : bn_threshold_fields()) {
+        stream << field.name << " = " << *field.value << '\n';
+    }
+}
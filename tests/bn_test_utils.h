@@ -0,0 +1,187 @@
+/* 
+ * File:   bn_test_utils.h
+ */
+
+#ifndef __BN_TEST_UTILS_H__
+#define	__BN_TEST_UTILS_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "bignum/bignum.h"
+
+/*
+ * Number of checks which have failed so far
+ */
+static unsigned bnTestFailures = 0;
+
+/*
+ * Record a failed check without stopping the test
+ */
+#define BN_TEST_CHECK(...) \
+    do { \
+        if (!(__VA_ARGS__)) { \
+            std::cerr << "Check failed on line " << __LINE__ << " of " << __FILE__ << ": " << #__VA_ARGS__ << std::endl; \
+            ++bnTestFailures; \
+        } \
+    } while (0)
+
+/*
+ * Fixed seed, so failures can be reproduced
+ */
+static std::mt19937_64 bnTestRng{0x5EED};
+
+/*
+ * Threshold which no test operand reaches, to turn an algorithm off
+ */
+static constexpr std::size_t BN_TEST_NEVER = 1u << 30;
+
+/*
+ * Saves every threshold of a limits_t on construction and restores them on
+ * destruction, so a test may lower them to run each algorithm on short
+ * operands.
+ */
+template <typename limits_t>
+struct BNTestThresholdGuard {
+    typedef BNThresholds<limits_t> thresholds_t;
+
+    const std::size_t mulKaratsuba = thresholds_t::mulKaratsuba;
+    const std::size_t sqrKaratsuba = thresholds_t::sqrKaratsuba;
+    const std::size_t mulToom3 = thresholds_t::mulToom3;
+    const std::size_t mulToom4 = thresholds_t::mulToom4;
+    const std::size_t mulFFT = thresholds_t::mulFFT;
+    const std::size_t mulUnbalanced = thresholds_t::mulUnbalanced;
+    const std::size_t divBurnikel = thresholds_t::divBurnikel;
+    const std::size_t divNewton = thresholds_t::divNewton;
+    const std::size_t divBarrett = thresholds_t::divBarrett;
+    const std::size_t divExact = thresholds_t::divExact;
+
+    BNTestThresholdGuard() = default;
+    BNTestThresholdGuard(const BNTestThresholdGuard&) = delete;
+    BNTestThresholdGuard& operator=(const BNTestThresholdGuard&) = delete;
+
+    ~BNTestThresholdGuard() {
+        thresholds_t::mulKaratsuba = mulKaratsuba;
+        thresholds_t::sqrKaratsuba = sqrKaratsuba;
+        thresholds_t::mulToom3 = mulToom3;
+        thresholds_t::mulToom4 = mulToom4;
+        thresholds_t::mulFFT = mulFFT;
+        thresholds_t::mulUnbalanced = mulUnbalanced;
+        thresholds_t::divBurnikel = divBurnikel;
+        thresholds_t::divNewton = divNewton;
+        thresholds_t::divBarrett = divBarrett;
+        thresholds_t::divExact = divExact;
+    }
+};
+
+/*
+ * @return A random number of exactly "len" digits.
+ */
+template <typename limits_t, typename container_t>
+container_t bn_test_digits(std::size_t len) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    container_t ret{};
+
+    for (std::size_t i = 0; i < len; ++i) {
+        ret.push_back((bn_single)(bnTestRng() % NUM_BASE));
+    }
+
+    if (len && !ret[len-1]) {
+        ret[len-1] = (bn_single)1;
+    }
+
+    return ret;
+}
+
+/*
+ * @return A random positive bignum of exactly "len" digits.
+ */
+template <typename limits_t, typename container_t>
+Bignum<limits_t, container_t> bn_test_number(std::size_t len) {
+    Bignum<limits_t, container_t> ret{};
+    ret.numData = bn_test_digits<limits_t, container_t>(len);
+    return ret;
+}
+
+/*
+ * @return A positive bignum holding the value of a native integer.
+ */
+template <typename limits_t, typename container_t>
+Bignum<limits_t, container_t> bn_test_native(bn_u64_t value) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    Bignum<limits_t, container_t> ret{};
+
+    while (value) {
+        ret.numData.push_back((bn_single)(value % NUM_BASE));
+        value /= NUM_BASE;
+    }
+
+    return ret;
+}
+
+/*
+ * Schoolbook product, kept separate from the library's own multiplication
+ * so it can be used as a reference.
+ * 
+ * @return The product of both numbers, with no leading zeroes.
+ */
+template <typename limits_t, typename container_t>
+container_t bn_test_mul(const container_t& a, const container_t& b) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    std::vector<bn_u64_t> sums(a.size() + b.size(), 0);
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        bn_u64_t carry = 0;
+
+        for (std::size_t j = 0; j < b.size(); ++j) {
+            const bn_u64_t t = sums[i+j] + (bn_u64_t)a[i] * (bn_u64_t)b[j] + carry;
+            sums[i+j] = t % NUM_BASE;
+            carry = t / NUM_BASE;
+        }
+
+        sums[i + b.size()] += carry;
+    }
+
+    container_t ret{};
+
+    for (bn_u64_t digit : sums) {
+        ret.push_back((bn_single)digit);
+    }
+
+    abs_val_trim<container_t>(ret);
+
+    return ret;
+}
+
+/*
+ * @return TRUE if both containers hold the same digits.
+ */
+template <typename container_t>
+bool bn_test_same(const container_t& a, const container_t& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+/*
+ * @return TRUE if both numbers have the same descriptor and magnitude, no
+ * matter how many leading zeroes either of them holds.
+ */
+template <typename limits_t, typename container_t>
+bool bn_test_same_value(const Bignum<limits_t, container_t>& a, const Bignum<limits_t, container_t>& b) {
+    container_t aDigits = a.numData;
+    container_t bDigits = b.numData;
+    abs_val_trim<container_t>(aDigits);
+    abs_val_trim<container_t>(bDigits);
+
+    return a.getDescriptor() == b.getDescriptor() && bn_test_same(aDigits, bDigits);
+}
+
+#endif	/* __BN_TEST_UTILS_H__ */
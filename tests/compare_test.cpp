@@ -0,0 +1,144 @@
+/* 
+ * File:   compare_test.cpp
+ */
+
+#include <deque>
+#include <vector>
+
+#include "bn_test_utils.h"
+
+/*
+ * Reference comparison, walking both numbers from the most significant
+ * digit down.
+ * 
+ * @return -1, 0 or 1 if "a" is less than, equal to or greater than "b".
+ */
+template <typename container_t>
+int bn_test_compare(const container_t& a, const container_t& b) {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+
+    std::size_t i = a.size();
+
+    while (i--) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Check every comparison of "a" and "b" against the reference.
+ */
+template <typename limits_t, typename container_t>
+void test_compare_pair(const container_t& a, const container_t& b) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const int cmp = bn_test_compare<container_t>(a, b);
+
+    BN_TEST_CHECK(abs_val_is_gt<container_t>(a, b) == (cmp > 0));
+    BN_TEST_CHECK(abs_val_is_ge<container_t>(a, b) == (cmp >= 0));
+    BN_TEST_CHECK(abs_val_is_lt<container_t>(a, b) == (cmp < 0));
+    BN_TEST_CHECK(abs_val_is_le<container_t>(a, b) == (cmp <= 0));
+    BN_TEST_CHECK(abs_val_is_eq<container_t>(a, b) == (cmp == 0));
+
+    bignum_t x{};
+    bignum_t y{};
+    x.numData = a;
+    y.numData = b;
+
+    BN_TEST_CHECK((x > y) == (cmp > 0));
+    BN_TEST_CHECK((x >= y) == (cmp >= 0));
+    BN_TEST_CHECK((x < y) == (cmp < 0));
+    BN_TEST_CHECK((x <= y) == (cmp <= 0));
+    BN_TEST_CHECK((x == y) == (cmp == 0));
+    BN_TEST_CHECK((x != y) == (cmp != 0));
+
+    // Any negative number is below any positive one
+    y.setDescriptor(BN_NEG);
+    BN_TEST_CHECK(x > y && x >= y && !(x < y) && !(x <= y) && x != y);
+    BN_TEST_CHECK(y < x && y <= x && !(y > x) && !(y >= x) && y != x);
+
+    // Negation reverses the order of distinct magnitudes
+    if (cmp != 0) {
+        x.setDescriptor(BN_NEG);
+        BN_TEST_CHECK((x > y) == (cmp < 0));
+        BN_TEST_CHECK((x >= y) == (cmp < 0));
+        BN_TEST_CHECK((x < y) == (cmp > 0));
+        BN_TEST_CHECK((x <= y) == (cmp > 0));
+    }
+}
+
+/*
+ * Numbers of the same length which differ in one digit, with random lower
+ * digits, so a greater lower digit must not outweigh a smaller higher one.
+ */
+template <typename limits_t, typename container_t>
+void test_compare(const char* typeName) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_single MAX_DIGIT = bn_max_limit<bn_single>();
+
+    const unsigned prevFailures = bnTestFailures;
+
+    for (std::size_t len = 1; len <= 6; ++len) {
+        for (unsigned iter = 0; iter < 50; ++iter) {
+            const container_t a = bn_test_digits<limits_t, container_t>(len);
+            container_t b = bn_test_digits<limits_t, container_t>(len);
+
+            const std::size_t pos = (std::size_t)(bnTestRng() % len);
+
+            for (std::size_t i = pos + 1; i < len; ++i) {
+                b[i] = a[i];
+            }
+
+            const bn_u64_t digit = (bn_u64_t)a[pos];
+            b[pos] = (bn_single)(digit < (bn_u64_t)MAX_DIGIT && (digit == 1 || bnTestRng() % 2) ? digit + 1 : digit - 1);
+
+            if (!b[pos] && pos == len - 1) {
+                b[pos] = (bn_single)(digit + 1);
+            }
+
+            test_compare_pair<limits_t, container_t>(a, b);
+            test_compare_pair<limits_t, container_t>(b, a);
+            test_compare_pair<limits_t, container_t>(a, a);
+        }
+
+        const container_t shorter = bn_test_digits<limits_t, container_t>(len);
+        const container_t longer = bn_test_digits<limits_t, container_t>(len + 1);
+        test_compare_pair<limits_t, container_t>(shorter, longer);
+        test_compare_pair<limits_t, container_t>(longer, shorter);
+    }
+
+    // 19 and 21, where the greater lower digit belongs to the smaller number
+    const container_t lowGreater{MAX_DIGIT, (bn_single)1};
+    const container_t highGreater{(bn_single)1, (bn_single)2};
+    test_compare_pair<limits_t, container_t>(lowGreater, highGreater);
+    test_compare_pair<limits_t, container_t>(highGreater, lowGreater);
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Comparison failed for " << typeName << std::endl;
+    }
+}
+
+template <typename limits_t>
+void test_compare_containers(const char* typeName) {
+    test_compare<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_compare<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+}
+
+int main() {
+    test_compare_containers<bn_limits_lowp>("bignum_lowp");
+    test_compare_containers<bn_limits_medp>("bignum_medp");
+    test_compare_containers<bn_limits_highp>("bignum_highp");
+    test_compare_containers<bn_limits_base2>("bignum_base2");
+    test_compare_containers<bn_limits_base8>("bignum_base8");
+    test_compare_containers<bn_limits_base10>("bignum_base10");
+    test_compare_containers<bn_limits_base16>("bignum_base16");
+
+    std::cout << "Comparison test: " << bnTestFailures << " failures" << std::endl;
+
+    return bnTestFailures ? 1 : 0;
+}
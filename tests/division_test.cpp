@@ -0,0 +1,586 @@
+/*
+ * File:   division_test.cpp
+ */
+
+#include <deque>
+
+#include "bn_test_utils.h"
+
+/*
+ * Division thresholds, lowered so short operands run through every
+ * algorithm.
+ */
+struct BNTestDivConfig {
+    const char* name;
+    std::size_t burnikel;
+    std::size_t newton;
+    std::size_t barrett;
+};
+
+static const BNTestDivConfig BN_TEST_DIV_CONFIGS[] = {
+    {"knuth",    BN_TEST_NEVER, BN_TEST_NEVER, BN_TEST_NEVER},
+    {"burnikel", 8,             BN_TEST_NEVER, BN_TEST_NEVER},
+    {"newton",   8,             16,            BN_TEST_NEVER},
+    {"barrett",  8,             16,            16}
+};
+
+template <typename limits_t>
+void set_div_thresholds(const BNTestDivConfig& config) {
+    BNThresholds<limits_t>::divBurnikel = config.burnikel;
+    BNThresholds<limits_t>::divNewton = config.newton;
+    BNThresholds<limits_t>::divBarrett = config.barrett;
+}
+
+/*
+ * @return A number of exactly "len" digits, drawn mostly from the extremes of
+ * a digit. These push quotient digit estimates furthest from the truth.
+ */
+template <typename limits_t, typename container_t>
+container_t bn_test_edge_digits(std::size_t len) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    const bn_u64_t edges[] = {0, 1, NUM_BASE/2, NUM_BASE-2, NUM_BASE-1, NUM_BASE-1};
+    container_t ret = bn_test_digits<limits_t, container_t>(len);
+
+    for (std::size_t i = 0; i < len; ++i) {
+        const std::size_t pick = bnTestRng() % 8;
+
+        if (pick < 6) {
+            ret[i] = (bn_single)edges[pick];
+        }
+    }
+
+    if (len && !ret[len-1]) {
+        ret[len-1] = (bn_single)(NUM_BASE-1);
+    }
+
+    return ret;
+}
+
+/*
+ * @return A number less than "b", which is neither negative nor zero.
+ */
+template <typename limits_t, typename container_t>
+Bignum<limits_t, container_t> bn_test_remainder(const Bignum<limits_t, container_t>& b) {
+    Bignum<limits_t, container_t> ret{};
+
+    if (bnTestRng() % 2) {
+        ret.numData = bn_test_digits<limits_t, container_t>(b.numData.size()-1);
+    }
+    else {
+        ret = b - Bignum<limits_t, container_t>{BN_POS, {1}};
+    }
+
+    return ret;
+}
+
+/*
+ * @return TRUE if a number is a positive zero. Zeroes may hold no digits, or
+ * a single zero digit.
+ */
+template <typename limits_t, typename container_t>
+bool bn_test_is_zero(const Bignum<limits_t, container_t>& num) {
+    return num.getDescriptor() == BN_POS
+        && std::all_of(num.numData.begin(), num.numData.end(), [](typename limits_t::base_single d) { return !d; });
+}
+
+/*
+ * Every number divided by itself is 1.
+ */
+template <typename limits_t, typename container_t>
+void test_div_self() {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    for (std::size_t len : {1, 2, 3, 10, 41}) {
+        const bignum_t one{BN_POS, {1}};
+        bignum_t a = bn_test_number<limits_t, container_t>(len);
+
+        BN_TEST_CHECK(a / a == one);
+
+        a.numData = bn_test_edge_digits<limits_t, container_t>(len);
+        BN_TEST_CHECK(a / a == one);
+
+        a.setDescriptor(BN_NEG);
+        BN_TEST_CHECK(a / a == one);
+    }
+}
+
+/*
+ * Divide (q*b + r) by b, for random multi-digit divisors.
+ */
+template <typename limits_t, typename container_t>
+void test_div_long() {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const std::size_t lens[][2] = {{1, 2}, {2, 2}, {5, 3}, {3, 9}, {30, 17}, {40, 40}};
+
+    for (const auto& len : lens) {
+        for (unsigned edges = 0; edges < 2; ++edges) {
+            bignum_t q{};
+            bignum_t b{};
+
+            if (edges) {
+                q.numData = bn_test_edge_digits<limits_t, container_t>(len[0]);
+                b.numData = bn_test_edge_digits<limits_t, container_t>(len[1]);
+            }
+            else {
+                q = bn_test_number<limits_t, container_t>(len[0]);
+                b = bn_test_number<limits_t, container_t>(len[1]);
+            }
+
+            bignum_t a{};
+            a.numData = bn_test_mul<limits_t, container_t>(q.numData, b.numData);
+            a += bn_test_remainder<limits_t, container_t>(b);
+
+            BN_TEST_CHECK(a / b == q);
+        }
+    }
+}
+
+/*
+ * @return TRUE if a number has the given sign and magnitude. A zero
+ * magnitude must be positive.
+ */
+template <typename limits_t, typename container_t>
+bool bn_test_equals(const Bignum<limits_t, container_t>& num, bn_desc_t desc, const container_t& digits) {
+    if (digits.empty()) {
+        return bn_test_is_zero(num);
+    }
+
+    container_t numDigits = num.numData;
+    abs_val_trim<container_t>(numDigits);
+
+    return num.getDescriptor() == desc && bn_test_same(numDigits, digits);
+}
+
+/*
+ * The quotient is truncated towards zero and the remainder takes the sign of
+ * the dividend, unless either of them is zero.
+ */
+template <typename limits_t, typename container_t>
+void test_divmod_signs() {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    // Quotient and divisor lengths, with or without a remainder
+    const std::size_t lens[][3] = {{1, 1, 1}, {1, 1, 0}, {0, 1, 1}, {4, 3, 1}, {4, 3, 0}, {0, 3, 1}, {3, 20, 1}};
+
+    for (const auto& len : lens) {
+        const container_t q = bn_test_digits<limits_t, container_t>(len[0]);
+        const container_t b = bn_test_digits<limits_t, container_t>(len[1]);
+        container_t r{};
+
+        if (len[2]) {
+            bignum_t divisor{};
+            divisor.numData = b;
+            r = (len[1] > 1)
+                ? bn_test_remainder<limits_t, container_t>(divisor).numData
+                : bn_test_digits<limits_t, container_t>(1);
+
+            // a single-digit remainder must still be below the divisor
+            if (len[1] == 1) {
+                r[0] = (typename limits_t::base_single)((bn_u64_t)r[0] % (bn_u64_t)b[0]);
+                abs_val_trim<container_t>(r);
+            }
+        }
+
+        // zero can only be positive
+        if (q.empty() && r.empty()) {
+            continue;
+        }
+
+        bignum_t qb{};
+        bignum_t rem{};
+        qb.numData = bn_test_mul<limits_t, container_t>(q, b);
+        rem.numData = r;
+
+        const bignum_t dividend = q.empty() ? rem : (r.empty() ? qb : qb + rem);
+
+        for (bn_desc_t aDesc : {BN_POS, BN_NEG}) {
+            for (bn_desc_t bDesc : {BN_POS, BN_NEG}) {
+                bignum_t x = dividend;
+                bignum_t y{};
+                x.setDescriptor(aDesc);
+                y.numData = b;
+                y.setDescriptor(bDesc);
+
+                const bn_desc_t qDesc = (aDesc == bDesc) ? BN_POS : BN_NEG;
+
+                BN_TEST_CHECK(bn_test_equals(x / y, qDesc, q));
+                BN_TEST_CHECK(bn_test_equals(x % y, aDesc, r));
+
+                bignum_t quotient = x;
+                bignum_t remainder{};
+                quotient.divmod(y, remainder);
+
+                BN_TEST_CHECK(bn_test_equals(quotient, qDesc, q));
+                BN_TEST_CHECK(bn_test_equals(remainder, aDesc, r));
+
+                const std::pair<bignum_t, bignum_t> results = divmod(x, y);
+
+                BN_TEST_CHECK(bn_test_equals(results.first, qDesc, q));
+                BN_TEST_CHECK(bn_test_equals(results.second, aDesc, r));
+            }
+        }
+    }
+}
+
+/*
+ * divmod() may write its remainder over the dividend or the divisor, and
+ * may divide a number by itself.
+ */
+template <typename limits_t, typename container_t>
+void test_divmod_aliasing() {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const bignum_t one{BN_POS, {1}};
+
+    for (std::size_t bLen : {1, 4}) {
+        for (bn_desc_t aDesc : {BN_POS, BN_NEG}) {
+            bignum_t x = bn_test_number<limits_t, container_t>(bLen + 5);
+            bignum_t y = bn_test_number<limits_t, container_t>(bLen);
+            x.setDescriptor(aDesc);
+            y.setDescriptor((bnTestRng() % 2) ? BN_POS : BN_NEG);
+
+            const bignum_t quotient = x / y;
+            const bignum_t remainder = x % y;
+
+            // The remainder replaces the quotient
+            bignum_t q = x;
+            q.divmod(y, q);
+            BN_TEST_CHECK(q == remainder);
+
+            // The divisor is read in full before the remainder replaces it
+            q = x;
+            bignum_t d = y;
+            q.divmod(d, d);
+            BN_TEST_CHECK(q == quotient && d == remainder);
+
+            bignum_t r{};
+            q = x;
+            q.divmod(q, r);
+            BN_TEST_CHECK(q == one && bn_test_is_zero(r));
+
+            q = x;
+            q.divmod(q, q);
+            BN_TEST_CHECK(bn_test_is_zero(q));
+        }
+    }
+}
+
+/*
+ * Compare division by a digit or a native integer against division by a
+ * bignum of the same value.
+ */
+template <typename limits_t, typename container_t>
+void test_div_scalar() {
+    typedef Bignum<limits_t, container_t> bignum_t;
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+    static constexpr bn_u64_t TWO_32 = bn_u64_t{1} << 32;
+
+    const bn_u64_t divisors[] = {
+        0, 1, 2, NUM_BASE-1, NUM_BASE, NUM_BASE+1,
+        TWO_32-1, TWO_32, TWO_32+1, 0x8000000000003039ull, ~bn_u64_t{0}
+    };
+
+    for (std::size_t len : {0, 1, 3, 12, 40}) {
+        for (bn_desc_t desc : {BN_POS, BN_NEG}) {
+            // zero can only be positive
+            if (!len && desc == BN_NEG) {
+                continue;
+            }
+
+            bignum_t x = bn_test_number<limits_t, container_t>(len);
+            x.setDescriptor(desc);
+
+            for (bn_u64_t divisor : divisors) {
+                const bignum_t d = bn_test_native<limits_t, container_t>(divisor);
+                const bignum_t quotient = x / d;
+                const bignum_t remainder = x % d;
+
+                bignum_t y = x;
+                y /= divisor;
+                BN_TEST_CHECK(bn_test_same_value(x / divisor, quotient));
+                BN_TEST_CHECK(bn_test_same_value(y, quotient));
+
+                y = x;
+                y %= divisor;
+                BN_TEST_CHECK(bn_test_same_value(x % divisor, remainder));
+                BN_TEST_CHECK(bn_test_same_value(y, remainder));
+
+                y = x;
+                const bn_u64_t rem = y.divmod_small(divisor);
+                BN_TEST_CHECK(bn_test_same_value(y, quotient));
+
+                if (divisor < TWO_32) {
+                    y = x;
+                    y /= (unsigned)divisor;
+                    BN_TEST_CHECK(bn_test_same_value(x / (unsigned)divisor, quotient));
+                    BN_TEST_CHECK(bn_test_same_value(y, quotient));
+                    BN_TEST_CHECK(bn_test_same_value(x % (unsigned)divisor, remainder));
+                }
+
+                if (divisor < NUM_BASE) {
+                    y = x;
+                    y /= (bn_single)divisor;
+                    BN_TEST_CHECK(bn_test_same_value(x / (bn_single)divisor, quotient));
+                    BN_TEST_CHECK(bn_test_same_value(y, quotient));
+
+                    y = x;
+                    y %= (bn_single)divisor;
+                    BN_TEST_CHECK(bn_test_same_value(x % (bn_single)divisor, remainder));
+                    BN_TEST_CHECK(bn_test_same_value(y, remainder));
+
+                    y = x;
+                    BN_TEST_CHECK(y.divmod_small((bn_single)divisor) == rem);
+                    BN_TEST_CHECK(bn_test_same_value(y, quotient));
+                }
+
+                // Dividing by zero leaves no remainder to compare
+                if (!divisor) {
+                    BN_TEST_CHECK(!rem);
+                    continue;
+                }
+
+                container_t remDigits = remainder.numData;
+                abs_val_trim<container_t>(remDigits);
+                BN_TEST_CHECK(bn_test_same(bn_test_native<limits_t, container_t>(rem).numData, remDigits));
+
+                container_t quotientDigits = quotient.numData;
+                container_t digits = x.numData;
+                abs_val_trim<container_t>(quotientDigits);
+                BN_TEST_CHECK(abs_val_div_native<limits_t, container_t>(digits, divisor) == rem);
+                abs_val_trim<container_t>(digits);
+                BN_TEST_CHECK(bn_test_same(digits, quotientDigits));
+
+                if (divisor <= TWO_32) {
+                    digits = x.numData;
+                    BN_TEST_CHECK(abs_val_div_small<limits_t, container_t>(digits, divisor) == rem);
+                    abs_val_trim<container_t>(digits);
+                    BN_TEST_CHECK(bn_test_same(digits, quotientDigits));
+                }
+            }
+        }
+    }
+
+    // Infinities and NaN keep their descriptor, and have no remainder
+    for (bn_desc_t desc : {BN_NAN, BN_POS_INF, BN_NEG_INF}) {
+        bignum_t x{};
+        x.setDescriptor(desc);
+
+        for (bn_u64_t divisor : {bn_u64_t{0}, bn_u64_t{3}, TWO_32 + 1}) {
+            BN_TEST_CHECK((x / divisor).getDescriptor() == desc);
+            BN_TEST_CHECK((x % divisor).getDescriptor() == BN_NAN);
+        }
+
+        BN_TEST_CHECK((x / (bn_single)1).getDescriptor() == desc);
+        BN_TEST_CHECK((x % (bn_single)1).getDescriptor() == BN_NAN);
+    }
+}
+
+/*
+ * Compare operator/, operator% and BignumDivisor against known quotients
+ * and remainders, using each division algorithm.
+ */
+template <typename limits_t, typename container_t>
+void test_div_algorithms(const char* typeName) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    // Quotient and divisor lengths
+    const std::size_t lens[][2] = {{20, 17}, {40, 40}, {100, 33}, {33, 70}, {3, 25}, {70, 9}};
+    const unsigned prevFailures = bnTestFailures;
+
+    for (const BNTestDivConfig& config : BN_TEST_DIV_CONFIGS) {
+        set_div_thresholds<limits_t>(config);
+
+        for (const auto& len : lens) {
+            const bignum_t b = bn_test_number<limits_t, container_t>(len[1]);
+            bignum_t y = b;
+            y.setDescriptor((bnTestRng() % 2) ? BN_POS : BN_NEG);
+
+            // The stored divisor is reused for numbers of different lengths
+            const BignumDivisor<limits_t, container_t> divisor{y};
+
+            for (std::size_t qLen : {len[0], len[0]/2 + 1}) {
+                const container_t q = bn_test_digits<limits_t, container_t>(qLen);
+                const bignum_t r = bn_test_remainder<limits_t, container_t>(b);
+
+                bignum_t x{};
+                x.numData = bn_test_mul<limits_t, container_t>(q, b.numData);
+                x += r;
+                x.setDescriptor((bnTestRng() % 2) ? BN_POS : BN_NEG);
+
+                const bn_desc_t qDesc = (x.getDescriptor() == y.getDescriptor()) ? BN_POS : BN_NEG;
+                const bignum_t quotient = x / y;
+                const bignum_t remainder = x % y;
+
+                BN_TEST_CHECK(bn_test_equals(quotient, qDesc, q));
+                BN_TEST_CHECK(bn_test_equals(remainder, x.getDescriptor(), r.numData));
+
+                const std::pair<bignum_t, bignum_t> results = divisor.divmod(x);
+
+                BN_TEST_CHECK(divisor.divide(x) == quotient);
+                BN_TEST_CHECK(divisor.mod(x) == remainder);
+                BN_TEST_CHECK(results.first == quotient && results.second == remainder);
+            }
+        }
+
+        if (bnTestFailures != prevFailures) {
+            std::cerr << "Division failed for " << typeName << " using " << config.name << std::endl;
+            return;
+        }
+    }
+}
+
+/*
+ * Compare divexact() against operator/, for divisors with low zero digits or
+ * factors shared with the base, with and without splitting the quotient.
+ */
+template <typename limits_t, typename container_t>
+void test_divexact(const char* typeName) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    // Quotient and divisor lengths
+    const std::size_t lens[][2] = {{1, 1}, {5, 3}, {20, 17}, {40, 9}, {9, 40}, {70, 33}};
+    const unsigned prevFailures = bnTestFailures;
+
+    for (std::size_t splitLen : {BN_TEST_NEVER, std::size_t{8}}) {
+        BNThresholds<limits_t>::divExact = splitLen;
+
+        for (const auto& len : lens) {
+            for (unsigned lowDigits = 0; lowDigits < 3; ++lowDigits) {
+                const container_t q = bn_test_digits<limits_t, container_t>(len[0]);
+                container_t b = bn_test_digits<limits_t, container_t>(len[1]);
+
+                if (lowDigits == 1) {
+                    b[0] = (bn_single)(NUM_BASE/2);
+                }
+                else if (lowDigits == 2) {
+                    b.insert(b.begin(), 2, bn_single{0});
+                }
+
+                bignum_t x{};
+                bignum_t y{};
+                x.numData = bn_test_mul<limits_t, container_t>(q, b);
+                y.numData = b;
+                x.setDescriptor((bnTestRng() % 2) ? BN_POS : BN_NEG);
+                y.setDescriptor((bnTestRng() % 2) ? BN_POS : BN_NEG);
+
+                const bignum_t quotient = divexact(x, y);
+
+                BN_TEST_CHECK(bn_test_equals(quotient, (x.getDescriptor() == y.getDescriptor()) ? BN_POS : BN_NEG, q));
+                BN_TEST_CHECK(quotient == x / y);
+            }
+        }
+
+        if (bnTestFailures != prevFailures) {
+            std::cerr << "Exact division failed for " << typeName << (splitLen == BN_TEST_NEVER ? " without" : " with") << " splitting" << std::endl;
+            return;
+        }
+    }
+}
+
+/*
+ * A finite number divided by an infinite one truncates to zero, leaving the
+ * number itself as the remainder. Dividing by zero gives an infinite
+ * quotient and no remainder.
+ */
+template <typename limits_t, typename container_t>
+void test_divmod_special() {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const bignum_t zero{};
+
+    for (std::size_t len : {1, 5}) {
+        for (bn_desc_t aDesc : {BN_POS, BN_NEG}) {
+            bignum_t x = bn_test_number<limits_t, container_t>(len);
+            x.setDescriptor(aDesc);
+
+            for (bn_desc_t infinity : {BN_POS_INF, BN_NEG_INF}) {
+                bignum_t y{};
+                y.setDescriptor(infinity);
+
+                BN_TEST_CHECK(bn_test_is_zero(x / y));
+                BN_TEST_CHECK(x % y == x);
+
+                const std::pair<bignum_t, bignum_t> results = divmod(x, y);
+
+                BN_TEST_CHECK(bn_test_is_zero(results.first));
+                BN_TEST_CHECK(results.second == x);
+            }
+
+            const std::pair<bignum_t, bignum_t> results = divmod(x, zero);
+
+            BN_TEST_CHECK(results.first.getDescriptor() == (aDesc == BN_POS ? BN_POS_INF : BN_NEG_INF));
+            BN_TEST_CHECK(results.second.getDescriptor() == BN_NAN);
+        }
+    }
+}
+
+/*
+ * Multi-digit highp division used to fault.
+ */
+void test_div_highp() {
+    const bn_limits_highp::base_single maxDigit = bn_max_limit<bn_limits_highp::base_single>();
+
+    // (2^96 - 1) / (2^64 - 1) == 2^32, with digits listed from the top
+    const bignum_highp a{BN_POS, {maxDigit, maxDigit, maxDigit}};
+    const bignum_highp b{BN_POS, {maxDigit, maxDigit}};
+    const bignum_highp q{BN_POS, {1, 0}};
+
+    BN_TEST_CHECK(a / b == q);
+    BN_TEST_CHECK(a / a == bignum_highp{BN_POS, {1}});
+    BN_TEST_CHECK(bn_test_is_zero(b / a));
+}
+
+template <typename limits_t>
+void test_div_containers(const char* typeName) {
+    const BNTestThresholdGuard<limits_t> thresholds;
+    const unsigned prevFailures = bnTestFailures;
+
+    test_div_self<limits_t, std::vector<typename limits_t::base_single>>();
+    test_div_self<limits_t, std::deque<typename limits_t::base_single>>();
+    test_div_long<limits_t, std::vector<typename limits_t::base_single>>();
+    test_div_long<limits_t, std::deque<typename limits_t::base_single>>();
+    test_divmod_signs<limits_t, std::vector<typename limits_t::base_single>>();
+    test_divmod_signs<limits_t, std::deque<typename limits_t::base_single>>();
+    test_divmod_aliasing<limits_t, std::vector<typename limits_t::base_single>>();
+    test_divmod_aliasing<limits_t, std::deque<typename limits_t::base_single>>();
+    test_div_scalar<limits_t, std::vector<typename limits_t::base_single>>();
+    test_div_scalar<limits_t, std::deque<typename limits_t::base_single>>();
+    test_divmod_special<limits_t, std::vector<typename limits_t::base_single>>();
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Division failed for " << typeName << std::endl;
+    }
+
+    // The recursive methods multiply through Karatsuba's method and the
+    // transforms
+    BNThresholds<limits_t>::mulKaratsuba = 4;
+    BNThresholds<limits_t>::sqrKaratsuba = 4;
+    BNThresholds<limits_t>::mulFFT = 24;
+
+    test_div_algorithms<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_div_algorithms<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+    test_divexact<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_divexact<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+}
+
+int main() {
+    test_div_containers<bn_limits_lowp>("bignum_lowp");
+    test_div_containers<bn_limits_medp>("bignum_medp");
+    test_div_containers<bn_limits_highp>("bignum_highp");
+    test_div_containers<bn_limits_base2>("bignum_base2");
+    test_div_containers<bn_limits_base8>("bignum_base8");
+    test_div_containers<bn_limits_base10>("bignum_base10");
+    test_div_containers<bn_limits_base16>("bignum_base16");
+
+    test_div_highp();
+
+    std::cout << "Division test: " << bnTestFailures << " failures" << std::endl;
+
+    return bnTestFailures ? 1 : 0;
+}
@@ -0,0 +1,413 @@
+/*
+ * File:   fourier_test.cpp
+ */
+
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <thread>
+
+#include "bn_test_utils.h"
+
+/*
+ * Number of jobs handed to bn_test_executor()
+ */
+static std::size_t bnTestExecutorJobs = 0;
+
+/*
+ * External executor which runs every task but the first on a thread of its
+ * own.
+ */
+void bn_test_executor(std::size_t numTasks, const std::function<void(std::size_t)>& task) {
+    std::vector<std::thread> threads;
+
+    ++bnTestExecutorJobs;
+
+    for (std::size_t i = 1; i < numTasks; ++i) {
+        threads.emplace_back(task, i);
+    }
+
+    task(0);
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+/*
+ * Compare transform products divided between threads, by the built-in pool
+ * and by an external executor, against the same products computed on the
+ * calling thread.
+ */
+template <typename limits_t, typename container_t>
+void test_parallel(const char* typeName) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const std::size_t lens[][2] = {{40, 40}, {300, 257}, {1200, 1200}, {2000, 60}};
+    const std::size_t prevParallelLength = fft_parallel_length();
+    const unsigned prevFailures = bnTestFailures;
+
+    for (const auto& len : lens) {
+        bignum_t x = bn_test_number<limits_t, container_t>(len[0]);
+        bignum_t y = bn_test_number<limits_t, container_t>(len[1]);
+        y.setDescriptor(BN_NEG);
+
+        fft_set_num_threads(1);
+
+        const container_t product = abs_val_mul<limits_t, container_t>(x.numData, y.numData);
+        const container_t square = abs_val_sqr<limits_t, container_t>(x.numData);
+        const bignum_t stored = BignumMultiplier<limits_t, container_t>{y}.multiply(x);
+
+        BN_TEST_CHECK(bn_test_same(product, bn_test_mul<limits_t, container_t>(x.numData, y.numData)));
+
+        // Short lengths are divided between threads too
+        fft_set_num_threads(4);
+        fft_set_parallel_length(16);
+
+        for (unsigned useExecutor = 0; useExecutor < 2; ++useExecutor) {
+            const std::size_t prevJobs = bnTestExecutorJobs;
+
+            if (useExecutor) {
+                fft_set_executor(bn_test_executor);
+            }
+
+            BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(x.numData, y.numData), product));
+            BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(y.numData, x.numData), product));
+            BN_TEST_CHECK(bn_test_same(abs_val_sqr<limits_t, container_t>(x.numData), square));
+            BN_TEST_CHECK(BignumMultiplier<limits_t, container_t>{y}.multiply(x) == stored);
+
+            if (useExecutor) {
+                BN_TEST_CHECK(bnTestExecutorJobs > prevJobs);
+                fft_set_executor(bn_executor_t{});
+            }
+        }
+
+        fft_set_parallel_length(prevParallelLength);
+        fft_set_num_threads(0);
+    }
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Parallel transforms failed for " << typeName << std::endl;
+    }
+}
+
+/*
+ * Products whose carries run across the chunks normalized by each thread.
+ * With every digit at its maximum, (b^n - 1)^2 carries out of nearly every
+ * coefficient, and (b^n - 1)(b^(n-1) + 1) leaves a run of maximum digits
+ * which a carry must ripple through.
+ */
+template <typename limits_t, typename container_t>
+void test_parallel_carries(const char* typeName) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_single MAX_DIGIT = bn_max_limit<bn_single>();
+
+    const std::size_t prevParallelLength = fft_parallel_length();
+    const unsigned prevFailures = bnTestFailures;
+
+    for (std::size_t len : {64, 257, 1500}) {
+        const container_t maxDigits(len, MAX_DIGIT);
+        container_t ends(len, bn_single{0});
+        ends.front() = (bn_single)1;
+        ends.back() = (bn_single)1;
+
+        for (const container_t& factor : {maxDigits, ends}) {
+            fft_set_num_threads(1);
+
+            const container_t product = abs_val_mul<limits_t, container_t>(maxDigits, factor);
+            const container_t square = abs_val_sqr<limits_t, container_t>(factor);
+
+            BN_TEST_CHECK(bn_test_same(product, bn_test_mul<limits_t, container_t>(maxDigits, factor)));
+            BN_TEST_CHECK(bn_test_same(square, bn_test_mul<limits_t, container_t>(factor, factor)));
+
+            fft_set_num_threads(4);
+            fft_set_parallel_length(16);
+
+            BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(maxDigits, factor), product));
+            BN_TEST_CHECK(bn_test_same(abs_val_sqr<limits_t, container_t>(factor), square));
+
+            fft_set_parallel_length(prevParallelLength);
+            fft_set_num_threads(0);
+        }
+    }
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Parallel carries failed for " << typeName << std::endl;
+    }
+}
+
+/*
+ * Compare transforms computed with the four-step algorithm against the
+ * plain radix-2 passes, on one thread and divided between several. Lengths
+ * of 3 and 5 times a power of 2 take the four-step path for their blocks.
+ */
+void test_four_step() {
+    const std::size_t lens[] = {16, 64, 128, 1024, 2048, 3 * 256, 5 * 512};
+    const std::size_t prevFourStepLength = fft_four_step_length();
+    const std::size_t prevParallelLength = fft_parallel_length();
+
+    for (std::size_t len : lens) {
+        cmplx_list_t<double> signal;
+        signal.resize(len);
+
+        for (std::size_t i = 0; i < len; ++i) {
+            signal.re[i] = std::sin(0.5 * i + 1.0);
+            signal.im[i] = std::cos(0.25 * i * i);
+        }
+
+        cmplx_list_t<double> expected = signal;
+        fft_set_four_step_length(0);
+        fft_complex<double>(expected);
+
+        for (unsigned numThreads : {1, 4}) {
+            fft_set_num_threads(numThreads);
+            fft_set_parallel_length(16);
+            fft_set_four_step_length(16);
+
+            cmplx_list_t<double> x = signal;
+            fft_complex<double>(x);
+
+            double maxError = 0;
+
+            for (std::size_t i = 0; i < len; ++i) {
+                maxError = std::max(maxError, std::abs(x.get(i) - expected.get(i)));
+            }
+
+            BN_TEST_CHECK(maxError < 1e-9 * len);
+
+            ifft_complex<double>(x);
+            maxError = 0;
+
+            for (std::size_t i = 0; i < len; ++i) {
+                maxError = std::max(maxError, std::abs(x.get(i) - signal.get(i)));
+            }
+
+            BN_TEST_CHECK(maxError < 1e-12 * len);
+
+            fft_set_four_step_length(prevFourStepLength);
+            fft_set_parallel_length(prevParallelLength);
+            fft_set_num_threads(0);
+        }
+    }
+}
+
+/*
+ * Products computed with the four-step algorithm match the schoolbook ones.
+ */
+template <typename limits_t, typename container_t>
+void test_four_step_products(const char* typeName) {
+    const std::size_t lens[][2] = {{40, 40}, {300, 257}, {1200, 1200}};
+    const std::size_t prevFourStepLength = fft_four_step_length();
+    const unsigned prevFailures = bnTestFailures;
+
+    fft_set_four_step_length(16);
+
+    for (const auto& len : lens) {
+        const container_t x = bn_test_digits<limits_t, container_t>(len[0]);
+        const container_t y = bn_test_digits<limits_t, container_t>(len[1]);
+
+        BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(x, y), bn_test_mul<limits_t, container_t>(x, y)));
+        BN_TEST_CHECK(bn_test_same(abs_val_sqr<limits_t, container_t>(x), bn_test_mul<limits_t, container_t>(x, x)));
+    }
+
+    fft_set_four_step_length(prevFourStepLength);
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Four-step products failed for " << typeName << std::endl;
+    }
+}
+
+/*
+ * Compare butterflies at every instruction set supported by the processor
+ * against the portable implementation, over whole passes and over strips
+ * which start past the first butterfly of each block.
+ */
+template <typename flt_t>
+void test_simd_butterflies(double tolerance) {
+    static constexpr double pi = 3.1415926535897932384626433832795;
+    static constexpr std::size_t len = 256;
+
+    const bn_simd_t prevLevel = fft_simd_level();
+
+    std::vector<flt_t> signalRe(len);
+    std::vector<flt_t> signalIm(len);
+
+    for (std::size_t i = 0; i < len; ++i) {
+        signalRe[i] = (flt_t)std::sin(0.5 * i + 1.0);
+        signalIm[i] = (flt_t)std::cos(0.25 * i * i);
+    }
+
+    for (int level = BN_SIMD_NONE; level <= fft_simd_support(); ++level) {
+        fft_set_simd_level((bn_simd_t)level);
+        BN_TEST_CHECK(fft_simd_level() == level);
+
+        for (std::size_t span = 1; span < len; span <<= 1) {
+            std::vector<flt_t> wRe(span);
+            std::vector<flt_t> wIm(span);
+
+            for (std::size_t k = 0; k < span; ++k) {
+                wRe[k] = (flt_t)std::cos(-pi * k / span);
+                wIm[k] = (flt_t)std::sin(-pi * k / span);
+            }
+
+            for (std::size_t first : {std::size_t{0}, span / 2 + 1}) {
+                if (first >= span) {
+                    continue;
+                }
+
+                const std::size_t count = span - first;
+
+                std::vector<flt_t> expectedRe = signalRe;
+                std::vector<flt_t> expectedIm = signalIm;
+                fft_butterflies_scalar<flt_t>(expectedRe.data() + first, expectedIm.data() + first, wRe.data() + first, wIm.data() + first, len, span, count);
+
+                std::vector<flt_t> re = signalRe;
+                std::vector<flt_t> im = signalIm;
+
+                if (first == 0) {
+                    fft_butterflies(re.data(), im.data(), wRe.data(), wIm.data(), len, span);
+                }
+                else {
+                    fft_butterflies(re.data() + first, im.data() + first, wRe.data() + first, wIm.data() + first, len, span, count);
+                }
+
+                double maxError = 0;
+
+                for (std::size_t i = 0; i < len; ++i) {
+                    maxError = std::max(maxError, (double)std::abs(re[i] - expectedRe[i]));
+                    maxError = std::max(maxError, (double)std::abs(im[i] - expectedIm[i]));
+                }
+
+                BN_TEST_CHECK(maxError <= tolerance);
+            }
+        }
+    }
+
+    // Requests past the processor's support fall back to it
+    fft_set_simd_level(BN_SIMD_AVX512);
+    BN_TEST_CHECK(fft_simd_level() == fft_simd_support());
+
+    fft_set_simd_level(prevLevel);
+}
+
+/*
+ * Products computed at every supported instruction set match the schoolbook
+ * ones.
+ */
+template <typename limits_t, typename container_t>
+void test_simd_products(const char* typeName) {
+    const std::size_t lens[][2] = {{40, 40}, {300, 257}, {1200, 1200}};
+    const bn_simd_t prevLevel = fft_simd_level();
+    const unsigned prevFailures = bnTestFailures;
+
+    for (int level = BN_SIMD_NONE; level <= fft_simd_support(); ++level) {
+        fft_set_simd_level((bn_simd_t)level);
+
+        for (const auto& len : lens) {
+            const container_t x = bn_test_digits<limits_t, container_t>(len[0]);
+            const container_t y = bn_test_digits<limits_t, container_t>(len[1]);
+
+            BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(x, y), bn_test_mul<limits_t, container_t>(x, y)));
+            BN_TEST_CHECK(bn_test_same(abs_val_sqr<limits_t, container_t>(x), bn_test_mul<limits_t, container_t>(x, x)));
+        }
+    }
+
+    fft_set_simd_level(prevLevel);
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "SIMD products failed for " << typeName << std::endl;
+    }
+}
+
+/*
+ * Longest length, up to 4095 digits, for which a predicate holds. Longer
+ * operands would make the schoolbook products too slow.
+ */
+template <typename predicate_t>
+std::size_t bn_test_longest(predicate_t isSupported) {
+    std::size_t len = 0;
+
+    for (std::size_t step = 2048; step; step >>= 1) {
+        if (isSupported(len + step)) {
+            len += step;
+        }
+    }
+
+    return len;
+}
+
+/*
+ * Products of numbers with every digit at its maximum, at the longest
+ * lengths transformed with whole digits and with digits split into bit
+ * fields, match the schoolbook ones. This is where the rounding margin left
+ * by fft_is_exact() is smallest.
+ */
+template <typename limits_t, typename container_t>
+void test_exact_bound(const char* typeName) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_single MAX_DIGIT = bn_max_limit<bn_single>();
+
+    const unsigned prevFailures = bnTestFailures;
+
+    const std::size_t wholeLen = bn_test_longest([](std::size_t len) {
+        return fft_is_exact<fft_float_t<limits_t>>(limits_t::SINGLE_BASE_MAX, len, len);
+    });
+
+    const std::size_t splitLen = bn_test_longest([](std::size_t len) {
+        return fft_num_pieces<double>(limits_t::SINGLE_BASE_MAX, len, len) != 0;
+    });
+
+    for (std::size_t len : {wholeLen, splitLen}) {
+        // digits too wide to be transformed whole
+        if (!len) {
+            continue;
+        }
+
+        const container_t maxDigits(len, MAX_DIGIT);
+        const container_t expected = bn_test_mul<limits_t, container_t>(maxDigits, maxDigits);
+
+        BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(maxDigits, maxDigits), expected));
+        BN_TEST_CHECK(bn_test_same(abs_val_sqr<limits_t, container_t>(maxDigits), expected));
+    }
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Exact transforms failed for " << typeName << std::endl;
+    }
+}
+
+template <typename limits_t>
+void test_fourier_containers(const char* typeName) {
+    const BNTestThresholdGuard<limits_t> thresholds;
+
+    // Every product goes through the transforms, including the chunks of
+    // unbalanced ones
+    BNThresholds<limits_t>::mulFFT = 24;
+    BNThresholds<limits_t>::mulUnbalanced = 24;
+
+    test_parallel<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_parallel<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+    test_parallel_carries<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_parallel_carries<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+    test_four_step_products<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_four_step_products<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+    test_simd_products<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_exact_bound<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+}
+
+int main() {
+    test_four_step();
+    test_simd_butterflies<float>(1e-5);
+    test_simd_butterflies<double>(1e-13);
+
+    test_fourier_containers<bn_limits_lowp>("bignum_lowp");
+    test_fourier_containers<bn_limits_medp>("bignum_medp");
+    test_fourier_containers<bn_limits_highp>("bignum_highp");
+    test_fourier_containers<bn_limits_base2>("bignum_base2");
+    test_fourier_containers<bn_limits_base8>("bignum_base8");
+    test_fourier_containers<bn_limits_base10>("bignum_base10");
+    test_fourier_containers<bn_limits_base16>("bignum_base16");
+
+    std::cout << "Fourier test: " << bnTestFailures << " failures" << std::endl;
+
+    return bnTestFailures ? 1 : 0;
+}
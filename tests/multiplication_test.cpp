@@ -0,0 +1,269 @@
+/* 
+ * File:   multiplication_test.cpp
+ */
+
+#include <deque>
+
+#include "bn_test_utils.h"
+
+/*
+ * Multiplication thresholds, lowered so short operands run through every
+ * algorithm.
+ */
+struct BNTestMulConfig {
+    const char* name;
+    std::size_t karatsuba;
+    std::size_t toom3;
+    std::size_t toom4;
+    std::size_t fft;
+    std::size_t unbalanced;
+};
+
+static const BNTestMulConfig BN_TEST_MUL_CONFIGS[] = {
+    {"karatsuba", 4,  BN_TEST_NEVER, BN_TEST_NEVER, BN_TEST_NEVER, BN_TEST_NEVER},
+    {"toom3",     4,  16,            BN_TEST_NEVER, BN_TEST_NEVER, BN_TEST_NEVER},
+    {"toom4",     4,  16,            40,            BN_TEST_NEVER, BN_TEST_NEVER},
+    {"fft",       4,  16,            40,            24,            BN_TEST_NEVER},
+    {"unbalanced",4,  16,            40,            24,            24}
+};
+
+template <typename limits_t>
+void set_mul_thresholds(const BNTestMulConfig& config) {
+    BNThresholds<limits_t>::mulKaratsuba = config.karatsuba;
+    BNThresholds<limits_t>::sqrKaratsuba = config.karatsuba;
+    BNThresholds<limits_t>::mulToom3 = config.toom3;
+    BNThresholds<limits_t>::mulToom4 = config.toom4;
+    BNThresholds<limits_t>::mulFFT = config.fft;
+    BNThresholds<limits_t>::mulUnbalanced = config.unbalanced;
+}
+
+/*
+ * Compare abs_val_mul(), abs_val_sqr(), operator* and
+ * BignumMultiplier::multiply() against a schoolbook product.
+ */
+template <typename limits_t, typename container_t>
+void test_mul(const char* typeName) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const std::size_t lens[][2] = {{1, 1}, {3, 70}, {17, 17}, {30, 200}, {63, 65}, {120, 130}};
+    const unsigned prevFailures = bnTestFailures;
+
+    for (const BNTestMulConfig& config : BN_TEST_MUL_CONFIGS) {
+        set_mul_thresholds<limits_t>(config);
+
+        for (const auto& len : lens) {
+            const container_t a = bn_test_digits<limits_t, container_t>(len[0]);
+            const container_t b = bn_test_digits<limits_t, container_t>(len[1]);
+            const container_t expected = bn_test_mul<limits_t, container_t>(a, b);
+
+            BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(a, b), expected));
+            BN_TEST_CHECK(bn_test_same(abs_val_mul<limits_t, container_t>(b, a), expected));
+            BN_TEST_CHECK(bn_test_same(abs_val_sqr<limits_t, container_t>(b), bn_test_mul<limits_t, container_t>(b, b)));
+
+            bignum_t x{};
+            bignum_t y{};
+            x.numData = a;
+            y.numData = b;
+            y.setDescriptor(BN_NEG);
+
+            // The stored factor is reused for operands of different lengths
+            BignumMultiplier<limits_t, container_t> multiplier{y};
+            const bignum_t product = x * y;
+
+            BN_TEST_CHECK(bn_test_same(product.numData, expected) && product.getDescriptor() == BN_NEG);
+            BN_TEST_CHECK(multiplier.multiply(x) == product);
+            BN_TEST_CHECK(multiplier.multiply(y) == y * y);
+            BN_TEST_CHECK(multiplier.multiply(x) == product);
+
+            // A short factor splits long numbers into chunks
+            BignumMultiplier<limits_t, container_t> shortMultiplier{x};
+            BN_TEST_CHECK(shortMultiplier.multiply(y) == product);
+        }
+
+        if (bnTestFailures != prevFailures) {
+            std::cerr << "Multiplication failed for " << typeName << " using " << config.name << std::endl;
+            return;
+        }
+    }
+}
+
+/*
+ * Compare multiplication by a digit or a native integer against
+ * multiplication by a bignum of the same value.
+ */
+template <typename limits_t, typename container_t>
+void test_mul_scalar(const char* typeName) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+    static constexpr bn_u64_t TWO_32 = bn_u64_t{1} << 32;
+
+    const bn_u64_t factors[] = {
+        0, 1, 2, NUM_BASE-1, NUM_BASE, NUM_BASE+1,
+        TWO_32-1, TWO_32, TWO_32+1, 0x8000000000003039ull, ~bn_u64_t{0}
+    };
+    const unsigned prevFailures = bnTestFailures;
+
+    for (std::size_t len : {0, 1, 5, 40}) {
+        for (bn_desc_t desc : {BN_POS, BN_NEG}) {
+            // zero can only be positive
+            if (!len && desc == BN_NEG) {
+                continue;
+            }
+
+            bignum_t x = bn_test_number<limits_t, container_t>(len);
+            x.setDescriptor(desc);
+
+            for (bn_u64_t factor : factors) {
+                const bignum_t expected = x * bn_test_native<limits_t, container_t>(factor);
+                bignum_t y = x;
+                y *= factor;
+
+                BN_TEST_CHECK(bn_test_same_value(x * factor, expected));
+                BN_TEST_CHECK(bn_test_same_value(y, expected));
+
+                if (factor < TWO_32) {
+                    y = x;
+                    y *= (unsigned)factor;
+                    BN_TEST_CHECK(bn_test_same_value(x * (unsigned)factor, expected));
+                    BN_TEST_CHECK(bn_test_same_value(y, expected));
+                }
+
+                if (factor < NUM_BASE) {
+                    y = x;
+                    y *= (bn_single)factor;
+                    BN_TEST_CHECK(bn_test_same_value(x * (bn_single)factor, expected));
+                    BN_TEST_CHECK(bn_test_same_value(y, expected));
+                }
+
+                container_t expectedDigits = expected.numData;
+                container_t digits = x.numData;
+                abs_val_trim<container_t>(expectedDigits);
+                abs_val_mul_native<limits_t, container_t>(digits, factor);
+                abs_val_trim<container_t>(digits);
+                BN_TEST_CHECK(bn_test_same(digits, expectedDigits));
+
+                if (factor <= TWO_32) {
+                    digits = x.numData;
+                    abs_val_mul_small<limits_t, container_t>(digits, factor);
+                    abs_val_trim<container_t>(digits);
+                    BN_TEST_CHECK(bn_test_same(digits, expectedDigits));
+                }
+            }
+        }
+    }
+
+    // Infinities and NaN keep their descriptor
+    for (bn_desc_t desc : {BN_NAN, BN_POS_INF, BN_NEG_INF}) {
+        bignum_t x{};
+        x.setDescriptor(desc);
+
+        for (bn_u64_t factor : {bn_u64_t{0}, bn_u64_t{3}, TWO_32 + 1}) {
+            BN_TEST_CHECK((x * factor).getDescriptor() == desc);
+        }
+
+        BN_TEST_CHECK((x * (bn_single)1).getDescriptor() == desc);
+    }
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Scalar multiplication failed for " << typeName << std::endl;
+    }
+}
+
+/*
+ * Compare square(), sqr() and self-multiplication against a schoolbook
+ * product. Negative numbers square to positive ones, and infinities to
+ * positive infinity.
+ */
+template <typename limits_t, typename container_t>
+void test_sqr(const char* typeName) {
+    typedef Bignum<limits_t, container_t> bignum_t;
+
+    const unsigned prevFailures = bnTestFailures;
+
+    for (const BNTestMulConfig& config : BN_TEST_MUL_CONFIGS) {
+        set_mul_thresholds<limits_t>(config);
+
+        for (std::size_t len : {0, 1, 3, 17, 64, 130}) {
+            for (bn_desc_t desc : {BN_POS, BN_NEG}) {
+                // zero can only be positive
+                if (!len && desc == BN_NEG) {
+                    continue;
+                }
+
+                bignum_t x = bn_test_number<limits_t, container_t>(len);
+                x.setDescriptor(desc);
+
+                bignum_t expected{};
+
+                if (len) {
+                    expected.numData = bn_test_mul<limits_t, container_t>(x.numData, x.numData);
+                }
+
+                const bignum_t copy = x;
+                BN_TEST_CHECK(bn_test_same_value(x * copy, expected));
+                BN_TEST_CHECK(bn_test_same_value(x.square(), expected));
+
+                bignum_t y = x;
+                BN_TEST_CHECK(&y.sqr() == &y);
+                BN_TEST_CHECK(bn_test_same_value(y, expected));
+
+                y = x;
+                y *= y;
+                BN_TEST_CHECK(bn_test_same_value(y, expected));
+            }
+        }
+
+        if (bnTestFailures != prevFailures) {
+            std::cerr << "Squaring failed for " << typeName << " using " << config.name << std::endl;
+            return;
+        }
+    }
+
+    const bn_desc_t specials[][2] = {{BN_NAN, BN_NAN}, {BN_POS_INF, BN_POS_INF}, {BN_NEG_INF, BN_POS_INF}};
+
+    for (const auto& special : specials) {
+        bignum_t x{};
+        x.setDescriptor(special[0]);
+
+        BN_TEST_CHECK(x.square().getDescriptor() == special[1]);
+
+        bignum_t y = x;
+        y.sqr();
+        BN_TEST_CHECK(y.getDescriptor() == special[1]);
+
+        y = x;
+        y *= y;
+        BN_TEST_CHECK(y.getDescriptor() == special[1]);
+    }
+
+    if (bnTestFailures != prevFailures) {
+        std::cerr << "Squaring failed for " << typeName << std::endl;
+    }
+}
+
+template <typename limits_t>
+void test_mul_containers(const char* typeName) {
+    const BNTestThresholdGuard<limits_t> thresholds;
+
+    test_mul<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_mul<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+    test_mul_scalar<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_mul_scalar<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+    test_sqr<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_sqr<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+}
+
+int main() {
+    test_mul_containers<bn_limits_lowp>("bignum_lowp");
+    test_mul_containers<bn_limits_medp>("bignum_medp");
+    test_mul_containers<bn_limits_highp>("bignum_highp");
+    test_mul_containers<bn_limits_base2>("bignum_base2");
+    test_mul_containers<bn_limits_base8>("bignum_base8");
+    test_mul_containers<bn_limits_base10>("bignum_base10");
+    test_mul_containers<bn_limits_base16>("bignum_base16");
+
+    std::cout << "Multiplication test: " << bnTestFailures << " failures" << std::endl;
+
+    return bnTestFailures ? 1 : 0;
+}
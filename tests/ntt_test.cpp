@@ -0,0 +1,53 @@
+/* 
+ * File:   ntt_test.cpp
+ */
+
+#include <deque>
+
+#include "bn_test_utils.h"
+
+/*
+ * Compare mul_ntt() against a schoolbook product, using one, two or three
+ * primes depending on the width of each digit.
+ */
+template <typename limits_t, typename container_t>
+void test_ntt(const char* typeName) {
+    const std::size_t lens[][2] = {{1, 1}, {1, 7}, {13, 13}, {64, 200}, {300, 257}};
+
+    for (const auto& len : lens) {
+        const container_t a = bn_test_digits<limits_t, container_t>(len[0]);
+        const container_t b = bn_test_digits<limits_t, container_t>(len[1]);
+        const container_t expected = bn_test_mul<limits_t, container_t>(a, b);
+
+        BN_TEST_CHECK(bn_test_same(mul_ntt<limits_t, container_t>(a, b), expected));
+        BN_TEST_CHECK(bn_test_same(mul_ntt<limits_t, container_t>(a, a), bn_test_mul<limits_t, container_t>(a, a)));
+
+        // Small transforms force the operands to be split in halves
+        BN_TEST_CHECK(bn_test_same(mul_ntt_split<limits_t, container_t>(a, b, 16), expected));
+        BN_TEST_CHECK(bn_test_same(mul_ntt_split<limits_t, container_t>(b, a, 64), expected));
+    }
+
+    if (bnTestFailures) {
+        std::cerr << "NTT multiplication failed for " << typeName << std::endl;
+    }
+}
+
+template <typename limits_t>
+void test_ntt_containers(const char* typeName) {
+    test_ntt<limits_t, std::vector<typename limits_t::base_single>>(typeName);
+    test_ntt<limits_t, std::deque<typename limits_t::base_single>>(typeName);
+}
+
+int main() {
+    test_ntt_containers<bn_limits_lowp>("bignum_lowp");
+    test_ntt_containers<bn_limits_medp>("bignum_medp");
+    test_ntt_containers<bn_limits_highp>("bignum_highp");
+    test_ntt_containers<bn_limits_base2>("bignum_base2");
+    test_ntt_containers<bn_limits_base8>("bignum_base8");
+    test_ntt_containers<bn_limits_base10>("bignum_base10");
+    test_ntt_containers<bn_limits_base16>("bignum_base16");
+
+    std::cout << "NTT test: " << bnTestFailures << " failures" << std::endl;
+
+    return bnTestFailures ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * File:   thresholds_test.cpp
+ */
+
+#include <sstream>
+
+#include "bn_test_utils.h"
+
+typedef BNThresholds<bn_limits_highp> bn_test_thresholds;
+
+/*
+ * Thresholds which are saved and loaded again keep their values.
+ */
+void test_round_trip() {
+    const std::size_t prevFFT = bn_test_thresholds::mulFFT;
+
+    std::stringstream stream;
+    bn_save_thresholds(stream);
+
+    bn_test_thresholds::mulFFT = prevFFT + 1;
+
+    BN_TEST_CHECK(bn_load_thresholds(stream));
+    BN_TEST_CHECK(bn_test_thresholds::mulFFT == prevFFT);
+}
+
+/*
+ * Valid lines are applied, along with comments and blank lines.
+ */
+void test_valid_lines() {
+    const std::size_t prevToom3 = bn_test_thresholds::mulToom3;
+
+    std::istringstream stream{
+        "# comment\n"
+        "\n"
+        "highp.mulToom3 = 1000  # trailing comment\n"
+    };
+
+    BN_TEST_CHECK(bn_load_thresholds(stream));
+    BN_TEST_CHECK(bn_test_thresholds::mulToom3 == 1000);
+
+    bn_test_thresholds::mulToom3 = prevToom3;
+}
+
+/*
+ * Lengths below the minimum of an algorithm are rejected, without stopping
+ * the other lines from being applied.
+ */
+void test_invalid_lines() {
+    const std::size_t prevKaratsuba = bn_test_thresholds::mulKaratsuba;
+    const std::size_t prevToom3 = bn_test_thresholds::mulToom3;
+    const std::size_t prevNewton = bn_test_thresholds::divNewton;
+    const std::size_t prevBurnikel = bn_test_thresholds::divBurnikel;
+
+    std::istringstream stream{
+        "highp.mulToom3 = 0\n"
+        "highp.mulKaratsuba = 0\n"
+        "highp.divNewton = 1\n"
+        "highp.divBurnikel = 200\n"
+    };
+
+    BN_TEST_CHECK(!bn_load_thresholds(stream));
+    BN_TEST_CHECK(bn_test_thresholds::mulToom3 == prevToom3);
+    BN_TEST_CHECK(bn_test_thresholds::mulKaratsuba == prevKaratsuba);
+    BN_TEST_CHECK(bn_test_thresholds::divNewton == prevNewton);
+    BN_TEST_CHECK(bn_test_thresholds::divBurnikel == 200);
+
+    for (const char* line : {"highp.mulToom9 = 100\n", "highp.mulFFT\n", "highp.mulFFT = x\n", "highp.mulFFT = 0\n"}) {
+        std::istringstream badStream{line};
+        BN_TEST_CHECK(!bn_load_thresholds(badStream));
+    }
+
+    bn_test_thresholds::divBurnikel = prevBurnikel;
+}
+
+int main() {
+    test_round_trip();
+    test_valid_lines();
+    test_invalid_lines();
+
+    std::cout << "Thresholds test: " << bnTestFailures << " failures" << std::endl;
+
+    return bnTestFailures ? 1 : 0;
+}
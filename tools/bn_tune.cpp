@@ -0,0 +1,512 @@
+/*
+ * File:   bn_tune.cpp
+ */
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "bignum/bignum.h"
+
+/*
+ * Measure the crossover points between the multiplication and division
+ * algorithms of each built-in bignum type on this machine, then write them out in the
+ * format read by bn_load_thresholds().
+ *
+ * usage: bn_tune [-o file] [type ...]
+ *
+ * Types are named by the suffix of their typedef (lowp, medp, highp, base2,
+ * base8, base10, base16). All of them are tuned when none are given, and
+ * the defaults of any others are written unchanged.
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Timing
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Each function is repeated for at least this many seconds per sample.
+ */
+static constexpr double BN_TUNE_MIN_TIME = 0.002;
+
+/*
+ * Number of samples of which the fastest is kept.
+ */
+static constexpr unsigned BN_TUNE_NUM_SAMPLES = 5;
+
+/*
+ * Placeholder for thresholds which should never be reached while another
+ * one is being measured.
+ */
+static constexpr std::size_t BN_TUNE_DISABLED = std::numeric_limits<std::size_t>::max() / 16;
+
+/*
+ * Number of dividends a BignumDivisor is timed against, on top of its own
+ * construction. A stored reciprocal has to pay for itself within them.
+ */
+static constexpr unsigned BN_TUNE_DIVISOR_USES = 4;
+
+static constexpr bn_u64_t BN_TUNE_SEED = 0x5EED;
+
+static std::mt19937_64 bnTuneRng{BN_TUNE_SEED};
+
+
+
+/*
+ * @return The fastest time of a single call to a function, in seconds.
+ */
+static double bn_tune_time(const std::function<void()>& func) {
+    typedef std::chrono::steady_clock clock_type;
+
+    std::size_t numCalls = 1;
+    double best = std::numeric_limits<double>::max();
+
+    for (unsigned sample = 0; sample < BN_TUNE_NUM_SAMPLES; ++sample) {
+        double elapsed;
+
+        for (;;) {
+            const clock_type::time_point start = clock_type::now();
+
+            for (std::size_t i = 0; i < numCalls; ++i) {
+                func();
+            }
+
+            elapsed = std::chrono::duration<double>(clock_type::now() - start).count();
+
+            if (elapsed >= BN_TUNE_MIN_TIME) {
+                break;
+            }
+
+            numCalls *= 2;
+        }
+
+        if (elapsed / numCalls < best) {
+            best = elapsed / numCalls;
+        }
+    }
+
+    return best;
+}
+
+
+
+/*
+ * @return A random number of exactly "len" digits.
+ */
+template <typename limits_t, typename container_t>
+static container_t bn_tune_digits(std::size_t len) {
+    typedef typename limits_t::base_single bn_single;
+    static constexpr bn_u64_t NUM_BASE = bn_u64_t{limits_t::SINGLE_BASE_MAX} + 1;
+
+    container_t ret{};
+
+    for (std::size_t i = 0; i < len; ++i) {
+        ret.push_back((bn_single)(bnTuneRng() % NUM_BASE));
+    }
+
+    if (len) {
+        ret[len-1] = (bn_single)(bn_u64_t{limits_t::SINGLE_BASE_MAX});
+    }
+
+    return ret;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Crossover search
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * Compare two algorithms at increasing lengths. The crossover is the first
+ * length at which the newer algorithm wins at two consecutive lengths. If
+ * it never does, the threshold is placed beyond the longest length tried.
+ *
+ * Both functions receive the length being measured, and return the time of
+ * a single call. The random number generator is reseeded before each of
+ * them, so both are given the same operands.
+ */
+static std::size_t bn_tune_crossover(
+    const std::string& name,
+    std::size_t minLen,
+    std::size_t maxLen,
+    const std::function<double(std::size_t)>& timeOld,
+    const std::function<double(std::size_t)>& timeNew
+) {
+    std::size_t candidate = 0;
+
+    for (std::size_t len = minLen; len <= maxLen; len += len/8 + 1) {
+        bnTuneRng.seed(BN_TUNE_SEED + len);
+        const double oldTime = timeOld(len);
+
+        bnTuneRng.seed(BN_TUNE_SEED + len);
+        const double newTime = timeNew(len);
+
+        std::cerr << "    " << name << ' ' << len << ": " << (newTime / oldTime) << '\n';
+
+        if (newTime >= oldTime) {
+            candidate = 0;
+        }
+        else if (!candidate) {
+            candidate = len;
+        }
+        else {
+            std::cerr << name << " = " << candidate << std::endl;
+            return candidate;
+        }
+    }
+
+    std::cerr << name << " = " << (maxLen+1) << " (no crossover found)" << std::endl;
+    return maxLen + 1;
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Multiplication thresholds
+///////////////////////////////////////////////////////////////////////////////
+template <typename limits_t>
+static void bn_tune_multiplication(const std::string& typeName) {
+    typedef bn_default_container_t<typename limits_t::base_single> container_t;
+    typedef BNThresholds<limits_t> thresholds_t;
+
+    std::cerr << "Tuning " << typeName << std::endl;
+
+    // Each method is compared against the one below it, with every method
+    // above it disabled.
+    thresholds_t::mulToom3 = BN_TUNE_DISABLED;
+    thresholds_t::mulToom4 = BN_TUNE_DISABLED;
+    thresholds_t::mulFFT = BN_TUNE_DISABLED;
+    thresholds_t::mulUnbalanced = BN_TUNE_DISABLED;
+
+    // A single level of Karatsuba's method, using schoolbook products below
+    thresholds_t::mulKaratsuba = bn_tune_crossover(
+        typeName + ".mulKaratsuba", 8, 256,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            return bn_tune_time([&]() { mul_naive<limits_t, container_t>(a, b); });
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::mulKaratsuba;
+            thresholds_t::mulKaratsuba = len;
+            const double ret = bn_tune_time([&]() { mul_karatsuba<limits_t, container_t>(a, b); });
+            thresholds_t::mulKaratsuba = prev;
+            return ret;
+        }
+    );
+
+    thresholds_t::sqrKaratsuba = bn_tune_crossover(
+        typeName + ".sqrKaratsuba", 8, 512,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            return bn_tune_time([&]() { sqr_naive<limits_t, container_t>(a); });
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::sqrKaratsuba;
+            thresholds_t::sqrKaratsuba = len;
+            const double ret = bn_tune_time([&]() { sqr_karatsuba<limits_t, container_t>(a); });
+            thresholds_t::sqrKaratsuba = prev;
+            return ret;
+        }
+    );
+
+    // One level of Toom-Cook, with its parts multiplied by the methods below
+    thresholds_t::mulToom3 = bn_tune_crossover(
+        typeName + ".mulToom3", 32, 4096,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            return bn_tune_time([&]() { mul_karatsuba<limits_t, container_t>(a, b); });
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::mulToom3;
+            thresholds_t::mulToom3 = len;
+            const double ret = bn_tune_time([&]() { mul_toom3<limits_t, container_t>(a, b); });
+            thresholds_t::mulToom3 = prev;
+            return ret;
+        }
+    );
+
+    thresholds_t::mulToom4 = bn_tune_crossover(
+        typeName + ".mulToom4", 64, 16384,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            return bn_tune_time([&]() { mul_toom3<limits_t, container_t>(a, b); });
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::mulToom4;
+            thresholds_t::mulToom4 = len;
+            const double ret = bn_tune_time([&]() { mul_toom4<limits_t, container_t>(a, b); });
+            thresholds_t::mulToom4 = prev;
+            return ret;
+        }
+    );
+
+    // Transforms are compared against the best of every other method
+    thresholds_t::mulFFT = bn_tune_crossover(
+        typeName + ".mulFFT", 16, 16384,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            return bn_tune_time([&]() { abs_val_mul<limits_t, container_t>(a, b); });
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::mulFFT;
+            thresholds_t::mulFFT = len;
+            const double ret = bn_tune_time([&]() { abs_val_mul<limits_t, container_t>(a, b); });
+            thresholds_t::mulFFT = prev;
+            return ret;
+        }
+    );
+
+    // Unbalanced products are measured with a longer operand of 8 times
+    // the length of the shorter one.
+    const std::size_t minUnbalanced = (thresholds_t::mulFFT > 64) ? thresholds_t::mulFFT : 64;
+
+    thresholds_t::mulUnbalanced = bn_tune_crossover(
+        typeName + ".mulUnbalanced", minUnbalanced, 16384,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(8 * len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            return bn_tune_time([&]() { abs_val_mul<limits_t, container_t>(a, b); });
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(8 * len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::mulUnbalanced;
+            thresholds_t::mulUnbalanced = len;
+            const double ret = bn_tune_time([&]() { abs_val_mul<limits_t, container_t>(a, b); });
+            thresholds_t::mulUnbalanced = prev;
+            return ret;
+        }
+    );
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Division thresholds
+///////////////////////////////////////////////////////////////////////////////
+/*
+ * @return The time taken to build a BignumDivisor of "len" digits and divide
+ * BN_TUNE_DIVISOR_USES numbers of twice its length by it, with divBarrett
+ * set to a given value.
+ */
+template <typename limits_t, typename container_t>
+static double bn_tune_divisor(std::size_t len, std::size_t barrettLen) {
+    typedef BNThresholds<limits_t> thresholds_t;
+
+    Bignum<limits_t, container_t> b;
+    b.numData = bn_tune_digits<limits_t, container_t>(len);
+
+    Bignum<limits_t, container_t> a[BN_TUNE_DIVISOR_USES];
+
+    for (Bignum<limits_t, container_t>& dividend : a) {
+        dividend.numData = bn_tune_digits<limits_t, container_t>(2 * len);
+    }
+
+    const std::size_t prev = thresholds_t::divBarrett;
+    thresholds_t::divBarrett = barrettLen;
+
+    const double ret = bn_tune_time([&]() {
+        const BignumDivisor<limits_t, container_t> d{b};
+
+        for (const Bignum<limits_t, container_t>& dividend : a) {
+            d.divmod(dividend);
+        }
+    });
+
+    thresholds_t::divBarrett = prev;
+    return ret;
+}
+
+
+
+template <typename limits_t>
+static void bn_tune_division(const std::string& typeName) {
+    typedef bn_default_container_t<typename limits_t::base_single> container_t;
+    typedef BNThresholds<limits_t> thresholds_t;
+
+    // Divisions are measured with a quotient as long as the divisor, using
+    // the multiplication thresholds which were just measured. Recursive
+    // division is compared against long division, then Newton's method
+    // against the best of both, then a BignumDivisor with and without its
+    // reciprocal, including the cost of building it. Exact division is
+    // measured on its own.
+    thresholds_t::divNewton = BN_TUNE_DISABLED;
+
+    thresholds_t::divBurnikel = bn_tune_crossover(
+        typeName + ".divBurnikel", BN_BURNIKEL_MIN_LEN, 16384,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(2 * len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::divBurnikel;
+            thresholds_t::divBurnikel = BN_TUNE_DISABLED;
+            const double ret = bn_tune_time([&]() { container_t q = a; abs_val_div<limits_t, container_t>(q, b); });
+            thresholds_t::divBurnikel = prev;
+            return ret;
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(2 * len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::divBurnikel;
+            thresholds_t::divBurnikel = len;
+            const double ret = bn_tune_time([&]() { container_t q = a; abs_val_div<limits_t, container_t>(q, b); });
+            thresholds_t::divBurnikel = prev;
+            return ret;
+        }
+    );
+
+    thresholds_t::divNewton = bn_tune_crossover(
+        typeName + ".divNewton", thresholds_t::divBurnikel, 65536,
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(2 * len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::divNewton;
+            thresholds_t::divNewton = BN_TUNE_DISABLED;
+            const double ret = bn_tune_time([&]() { container_t q = a; abs_val_div<limits_t, container_t>(q, b); });
+            thresholds_t::divNewton = prev;
+            return ret;
+        },
+        [](std::size_t len)->double {
+            const container_t a = bn_tune_digits<limits_t, container_t>(2 * len);
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const std::size_t prev = thresholds_t::divNewton;
+            thresholds_t::divNewton = len;
+            const double ret = bn_tune_time([&]() { container_t q = a; abs_val_div<limits_t, container_t>(q, b); });
+            thresholds_t::divNewton = prev;
+            return ret;
+        }
+    );
+
+    // A stored reciprocal is compared against the other methods once a
+    // divisor is built and used for a few dividends, so Newton's method is
+    // timed on one side just as the normalization is on both.
+    thresholds_t::divBarrett = bn_tune_crossover(
+        typeName + ".divBarrett", BN_NEWTON_MIN_LEN, 16384,
+        [](std::size_t len)->double {
+            return bn_tune_divisor<limits_t, container_t>(len, BN_TUNE_DISABLED);
+        },
+        [](std::size_t len)->double {
+            return bn_tune_divisor<limits_t, container_t>(len, len);
+        }
+    );
+
+    thresholds_t::divExact = bn_tune_crossover(
+        typeName + ".divExact", BN_EXACT_MIN_LEN, 16384,
+        [](std::size_t len)->double {
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const container_t a = abs_val_mul<limits_t, container_t>(bn_tune_digits<limits_t, container_t>(len), b);
+            const std::size_t prev = thresholds_t::divExact;
+            thresholds_t::divExact = BN_TUNE_DISABLED;
+            const double ret = bn_tune_time([&]() { container_t q = a; abs_val_divexact<limits_t, container_t>(q, b); });
+            thresholds_t::divExact = prev;
+            return ret;
+        },
+        [](std::size_t len)->double {
+            const container_t b = bn_tune_digits<limits_t, container_t>(len);
+            const container_t a = abs_val_mul<limits_t, container_t>(bn_tune_digits<limits_t, container_t>(len), b);
+            const std::size_t prev = thresholds_t::divExact;
+            thresholds_t::divExact = len;
+            const double ret = bn_tune_time([&]() { container_t q = a; abs_val_divexact<limits_t, container_t>(q, b); });
+            thresholds_t::divExact = prev;
+            return ret;
+        }
+    );
+}
+
+
+
+template <typename limits_t>
+static void bn_tune_thresholds(const std::string& typeName) {
+    bn_tune_multiplication<limits_t>(typeName);
+    bn_tune_division<limits_t>(typeName);
+}
+
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Main
+///////////////////////////////////////////////////////////////////////////////
+struct BNTuneType {
+    const char* name;
+    void (*tune)(const std::string&);
+};
+
+
+
+int main(int argc, char** argv) {
+    const BNTuneType types[] = {
+        {"lowp", &bn_tune_thresholds<bn_limits_lowp>},
+        {"medp", &bn_tune_thresholds<bn_limits_medp>},
+        {"highp", &bn_tune_thresholds<bn_limits_highp>},
+        {"base2", &bn_tune_thresholds<bn_limits_base2>},
+        {"base8", &bn_tune_thresholds<bn_limits_base8>},
+        {"base10", &bn_tune_thresholds<bn_limits_base10>},
+        {"base16", &bn_tune_thresholds<bn_limits_base16>}
+    };
+
+    const char* outFile = nullptr;
+    bool selected[sizeof(types) / sizeof(types[0])] = {false};
+    bool anySelected = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-o") && i+1 < argc) {
+            outFile = argv[++i];
+            continue;
+        }
+
+        bool found = false;
+
+        for (std::size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+            if (!std::strcmp(argv[i], types[t].name)) {
+                selected[t] = true;
+                anySelected = true;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            std::cerr << "usage: " << argv[0] << " [-o file] [lowp|medp|highp|base2|base8|base10|base16 ...]" << std::endl;
+            return 1;
+        }
+    }
+
+    for (std::size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+        if (!anySelected || selected[t]) {
+            types[t].tune(types[t].name);
+        }
+    }
+
+    if (!outFile) {
+        std::cout << "# Bignum thresholds measured by bn_tune\n";
+        bn_save_thresholds(std::cout);
+        return 0;
+    }
+
+    std::ofstream out{outFile};
+
+    if (!out) {
+        std::cerr << "Unable to open " << outFile << " for writing." << std::endl;
+        return 1;
+    }
+
+    out << "# Bignum thresholds measured by bn_tune\n";
+    bn_save_thresholds(out);
+
+    return 0;
+}